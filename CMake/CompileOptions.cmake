@@ -12,6 +12,9 @@ if(CUBBYFLOW_WARNINGS_AS_ERRORS)
 	endif()
 endif()
 
+# Set single precision mesh attributes flag
+option(CUBBYCITY_MESH_FLOAT32 "Store mesh positions and normals in single precision" OFF)
+
 # Get upper case system name
 string(TOUPPER ${CMAKE_SYSTEM_NAME} SYSTEM_NAME_UPPER)
 
@@ -51,6 +54,12 @@ set(DEFAULT_COMPILE_DEFINITIONS
 	SYSTEM_${SYSTEM_NAME_UPPER}
 )
 
+if(CUBBYCITY_MESH_FLOAT32)
+	set(DEFAULT_COMPILE_DEFINITIONS ${DEFAULT_COMPILE_DEFINITIONS}
+		CUBBYCITY_MESH_FLOAT32
+	)
+endif()
+
 # MSVC compiler options
 if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
 	set(DEFAULT_COMPILE_DEFINITIONS ${DEFAULT_COMPILE_DEFINITIONS}
@@ -0,0 +1,110 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_BENCHMARK_DATA_HPP
+#define CUBBYCITY_BENCHMARK_DATA_HPP
+
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Geometry/GeometryData.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace CubbyCity
+{
+//! Rolling hills heightmap of \p size x \p size samples, in meters.
+inline std::unique_ptr<HeightData> MakeHeightData(int size)
+{
+    auto data = std::make_unique<HeightData>();
+    data->width = size;
+    data->height = size;
+    data->elevation.resize(size, std::vector<double>(size));
+
+    for (int x = 0; x < size; ++x)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            data->elevation[x][y] = 100.0 + 20.0 * std::sin(x * 0.05) +
+                                    15.0 * std::cos(y * 0.07);
+        }
+    }
+
+    return data;
+}
+
+//! Adds a closed, convex-ish ring of \p numVertices points around \p center.
+inline void AddRing(TileData& data, const Point& center, double radius,
+                    size_t numVertices, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> jitter(0.8, 1.0);
+    const size_t offset = data.points.size();
+
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        const double angle = 2.0 * MATH_PI * i / numVertices;
+        const double r = radius * jitter(rng);
+        data.points.emplace_back(center.x + r * std::cos(angle),
+                                 center.y + r * std::sin(angle), 0.0);
+    }
+
+    data.points.push_back(data.points[offset]);
+    data.lines.push_back({ offset, numVertices + 1 });
+}
+
+//! Tile with \p numBuildings footprints of \p numVertices vertices each,
+//! scattered over the tile square. Polygon i is footprint i.
+inline TileData MakeBuildings(size_t numBuildings, size_t numVertices,
+                              unsigned int seed = 1234)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(-0.95, 0.95);
+
+    TileData data;
+    data.points.reserve(numBuildings * (numVertices + 1));
+
+    for (size_t i = 0; i < numBuildings; ++i)
+    {
+        const size_t offset = data.lines.size();
+        AddRing(data, Point(position(rng), position(rng), 0.0), 0.01,
+                numVertices, rng);
+        data.polygons.push_back({ offset, 1 });
+    }
+
+    return data;
+}
+
+//! Tile with \p numRoads random walks of \p numPoints points each.
+inline TileData MakeRoads(size_t numRoads, size_t numPoints,
+                          unsigned int seed = 5678)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(-0.9, 0.9);
+    std::uniform_real_distribution<double> step(-0.02, 0.02);
+
+    TileData data;
+    data.points.reserve(numRoads * numPoints);
+
+    for (size_t r = 0; r < numRoads; ++r)
+    {
+        const size_t offset = data.points.size();
+        Point p(position(rng), position(rng), 0.0);
+
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            data.points.push_back(p);
+            p.x += 0.02 + std::abs(step(rng));
+            p.y += step(rng);
+        }
+
+        data.lines.push_back({ offset, numPoints });
+    }
+
+    return data;
+}
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_BENCHMARK_DATA_HPP
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "BenchmarkData.hpp"
+
+#include <CubbyCity/Exporter/OBJExporter.hpp>
+#include <CubbyCity/Geometry/Geometry.hpp>
+#include <CubbyCity/Geometry/GeometryUtils.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace CubbyCity;
+
+static void BM_OBJExporter(benchmark::State& state)
+{
+    const bool normals = state.range(1) != 0;
+
+    std::vector<std::unique_ptr<PolygonMesh>> meshes;
+    auto mesh = std::make_unique<PolygonMesh>();
+    Geometry::BuildPlane(*mesh, 2, 2, static_cast<int>(state.range(0)),
+                         static_cast<int>(state.range(0)));
+
+    if (normals)
+    {
+        ComputeNormals(*mesh);
+    }
+
+    const size_t numVertices = mesh->positions.size();
+    meshes.push_back(std::move(mesh));
+
+    // Measures formatting only, the output never reaches a disk
+    OBJExporter exporter;
+
+    for (auto _ : state)
+    {
+        exporter.Save("/dev/null", false, meshes, 0.0, 0.0, false, normals);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numVertices);
+}
+BENCHMARK(BM_OBJExporter)
+    ->Args({ 256, 0 })
+    ->Args({ 256, 1 })
+    ->Unit(benchmark::kMillisecond);
\ No newline at end of file
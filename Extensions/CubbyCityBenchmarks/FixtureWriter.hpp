@@ -0,0 +1,279 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_FIXTURE_WRITER_HPP
+#define CUBBYCITY_FIXTURE_WRITER_HPP
+
+#include <CubbyCity/Geometry/CityGenerator.hpp>
+#include <CubbyCity/Geometry/GeometryUtils.hpp>
+#include <CubbyCity/Platform/LocalDownloader.hpp>
+#include <CubbyCity/Platform/TileURLs.hpp>
+
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CubbyCity
+{
+//! Region of tiles written as fixtures, all at the same zoom level.
+struct FixtureRegion
+{
+    std::string name;
+    int startX, endX;
+    int startY, endY;
+    int zoom;
+    CityGeneratorConfig city;
+};
+
+inline std::uint32_t UpdateCRC32(std::uint32_t crc, const std::uint8_t* data,
+                                 size_t size)
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t n = 0; n < 256; ++n)
+        {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+//! Writes 8-bit RGBA pixels as a PNG with stored (uncompressed) deflate
+//! blocks, which is all stb_image needs to read it back.
+inline void WritePNG(const std::string& path, int width, int height,
+                     const std::vector<std::uint8_t>& rgba)
+{
+    auto put32 = [](std::vector<std::uint8_t>& out, std::uint32_t v) {
+        out.push_back(static_cast<std::uint8_t>(v >> 24));
+        out.push_back(static_cast<std::uint8_t>(v >> 16));
+        out.push_back(static_cast<std::uint8_t>(v >> 8));
+        out.push_back(static_cast<std::uint8_t>(v));
+    };
+
+    std::vector<std::uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a,
+                                      '\n' };
+
+    auto addChunk = [&](const char* type,
+                        const std::vector<std::uint8_t>& data) {
+        put32(png, static_cast<std::uint32_t>(data.size()));
+        const size_t begin = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        put32(png, UpdateCRC32(0, png.data() + begin, png.size() - begin));
+    };
+
+    std::vector<std::uint8_t> header;
+    put32(header, static_cast<std::uint32_t>(width));
+    put32(header, static_cast<std::uint32_t>(height));
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });
+    addChunk("IHDR", header);
+
+    // Scanlines with filter type 0
+    std::vector<std::uint8_t> raw;
+    const size_t stride = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba.begin() + y * stride,
+                   rgba.begin() + (y + 1) * stride);
+    }
+
+    std::vector<std::uint8_t> zlib = { 0x78, 0x01 };
+    std::uint32_t a = 1, b = 0;
+    for (size_t offset = 0; offset < raw.size();)
+    {
+        const size_t size = std::min<size_t>(raw.size() - offset, 65535);
+        const bool last = offset + size == raw.size();
+
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<std::uint8_t>(size));
+        zlib.push_back(static_cast<std::uint8_t>(size >> 8));
+        zlib.push_back(static_cast<std::uint8_t>(~size));
+        zlib.push_back(static_cast<std::uint8_t>(~size >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset,
+                    raw.begin() + offset + size);
+
+        for (size_t i = offset; i < offset + size; ++i)
+        {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+
+        offset += size;
+    }
+    put32(zlib, (b << 16) | a);
+
+    addChunk("IDAT", zlib);
+    addChunk("IEND", {});
+
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(png.data()),
+               static_cast<std::streamsize>(png.size()));
+}
+
+//! Encodes elevations (meters) as a terrarium PNG:
+//! elevation = red * 256 + green + blue / 256 - 32768.
+inline void WriteTerrariumTile(const std::string& path, const HeightData& data)
+{
+    std::vector<std::uint8_t> rgba(
+        static_cast<size_t>(data.width) * data.height * 4);
+
+    for (int y = 0; y < data.height; ++y)
+    {
+        for (int x = 0; x < data.width; ++x)
+        {
+            const double v = data.elevation[x][y] + 32768.0;
+            const double integer = std::floor(v);
+            std::uint8_t* pixel = &rgba[(y * data.width + x) * 4];
+
+            pixel[0] = static_cast<std::uint8_t>(integer / 256.0);
+            pixel[1] = static_cast<std::uint8_t>(std::fmod(integer, 256.0));
+            pixel[2] = static_cast<std::uint8_t>((v - integer) * 256.0);
+            pixel[3] = 255;
+        }
+    }
+
+    WritePNG(path, data.width, data.height, rgba);
+}
+
+//! Converts the lines of \p data from tile space back to GeoJSON lon/lat
+//! coordinates.
+inline nlohmann::json ToCoordinates(const TileData& data, size_t line,
+                                    const Tile& tile)
+{
+    nlohmann::json coordinates = nlohmann::json::array();
+
+    for (const auto& point : data.GetLine(line))
+    {
+        const glm::dvec2 meters(point.x / tile.invScale + tile.tileOrigin.x,
+                                point.y / tile.invScale + tile.tileOrigin.y);
+        const glm::dvec2 lonLat = ConvertMetersToLonLat(meters);
+        coordinates.push_back({ lonLat.x, lonLat.y });
+    }
+
+    return coordinates;
+}
+
+//! Writes the layers of \p data as a tilezen vector tile.
+inline void WriteVectorTile(const std::string& path, const Tile& tile,
+                            const TileData& data)
+{
+    nlohmann::json layers = nlohmann::json::object();
+
+    for (const auto& layer : data.layers)
+    {
+        nlohmann::json features = nlohmann::json::array();
+
+        for (const auto& feature : layer.features)
+        {
+            nlohmann::json geometry;
+
+            if (feature.geometryType == GeometryType::Polygons)
+            {
+                nlohmann::json polygons = nlohmann::json::array();
+
+                for (size_t p = 0; p < feature.polygons.count; ++p)
+                {
+                    const Range& polygon =
+                        data.polygons[feature.polygons.offset + p];
+                    nlohmann::json rings = nlohmann::json::array();
+
+                    for (size_t r = 0; r < polygon.count; ++r)
+                    {
+                        rings.push_back(
+                            ToCoordinates(data, polygon.offset + r, tile));
+                    }
+
+                    polygons.push_back(rings);
+                }
+
+                geometry = { { "type", "MultiPolygon" },
+                             { "coordinates", polygons } };
+            }
+            else if (feature.geometryType == GeometryType::Lines)
+            {
+                nlohmann::json lines = nlohmann::json::array();
+
+                for (size_t l = 0; l < feature.lines.count; ++l)
+                {
+                    lines.push_back(
+                        ToCoordinates(data, feature.lines.offset + l, tile));
+                }
+
+                geometry = { { "type", "MultiLineString" },
+                             { "coordinates", lines } };
+            }
+            else
+            {
+                continue;
+            }
+
+            features.push_back({ { "type", "Feature" },
+                                 { "properties", feature.props.numericProps },
+                                 { "geometry", geometry } });
+        }
+
+        layers[layer.name]["features"] = features;
+    }
+
+    std::ofstream file(path);
+    file << layers.dump();
+}
+
+//! Writes the vector and terrain tiles of \p region under \p rootDir, laid
+//! out as LocalDownloader expects them.
+inline void WriteRegionFixtures(const std::string& rootDir,
+                                const FixtureRegion& region)
+{
+    const LocalDownloader source(rootDir);
+    const CityGenerator generator(region.city);
+
+    for (int x = region.startX; x <= region.endX; ++x)
+    {
+        for (int y = region.startY; y <= region.endY; ++y)
+        {
+            const Tile tile(x, y, region.zoom);
+
+            const std::string vectorPath =
+                source.GetFilePath(GetVectorTileURL(tile, ""));
+            const std::string terrainPath =
+                source.GetFilePath(GetTerrainURL(tile, ""));
+
+            std::filesystem::create_directories(
+                std::filesystem::path(vectorPath).parent_path());
+            std::filesystem::create_directories(
+                std::filesystem::path(terrainPath).parent_path());
+
+            WriteVectorTile(vectorPath, tile, *generator.GenerateTileData(tile));
+            WriteTerrariumTile(terrainPath,
+                               *generator.GenerateHeightData(tile, 1.0));
+        }
+    }
+}
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_FIXTURE_WRITER_HPP
\ No newline at end of file
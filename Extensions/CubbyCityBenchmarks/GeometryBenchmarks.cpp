@@ -0,0 +1,96 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "BenchmarkData.hpp"
+
+#include <CubbyCity/Geometry/Geometry.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace CubbyCity;
+
+static void BM_BuildPlane(benchmark::State& state)
+{
+    const int subDiv = static_cast<int>(state.range(0));
+
+    for (auto _ : state)
+    {
+        PolygonMesh mesh;
+        Geometry::BuildPlane(mesh, 2, 2, subDiv, subDiv);
+        benchmark::DoNotOptimize(mesh.positions.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * subDiv * subDiv * 2);
+}
+BENCHMARK(BM_BuildPlane)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+static void BM_BuildPolygonExtrusion(benchmark::State& state)
+{
+    const TileData data = MakeBuildings(1000, state.range(0));
+    const auto heightData = MakeHeightData(256);
+    const double invScale = 1.0 / 300.0;
+
+    for (auto _ : state)
+    {
+        PolygonMesh mesh;
+
+        for (size_t i = 0; i < data.polygons.size(); ++i)
+        {
+            Geometry::BuildPolygonExtrusion(data.GetPolygon(i), 0.0,
+                                            20.0 * invScale, mesh, heightData,
+                                            invScale);
+        }
+
+        benchmark::DoNotOptimize(mesh.positions.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * data.polygons.size());
+}
+BENCHMARK(BM_BuildPolygonExtrusion)
+    ->Arg(8)
+    ->Arg(64)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_BuildPolygon(benchmark::State& state)
+{
+    const TileData data = MakeBuildings(1000, state.range(0));
+    const double invScale = 1.0 / 300.0;
+
+    for (auto _ : state)
+    {
+        PolygonMesh mesh;
+
+        for (size_t i = 0; i < data.polygons.size(); ++i)
+        {
+            Geometry::BuildPolygon(data.GetPolygon(i), 20.0 * invScale, mesh,
+                                   0.0, invScale);
+        }
+
+        benchmark::DoNotOptimize(mesh.indices.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * data.polygons.size());
+}
+BENCHMARK(BM_BuildPolygon)->Arg(8)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+static void BM_BuildRoads(benchmark::State& state)
+{
+    const TileData data = MakeRoads(500, state.range(0));
+    const Range lines{ 0, data.lines.size() };
+    const auto heightData = MakeHeightData(256);
+    const double invScale = 1.0 / 300.0;
+
+    for (auto _ : state)
+    {
+        PolygonMesh mesh;
+        Geometry::BuildRoads(data, lines, mesh, heightData, 5.0, 1.0,
+                             invScale);
+        benchmark::DoNotOptimize(mesh.positions.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * data.lines.size());
+}
+BENCHMARK(BM_BuildRoads)->Arg(2)->Arg(32)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
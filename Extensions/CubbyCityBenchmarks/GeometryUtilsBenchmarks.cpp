@@ -0,0 +1,110 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "BenchmarkData.hpp"
+
+#include <CubbyCity/Geometry/GeometryUtils.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace CubbyCity;
+
+static void BM_SampleElevation(benchmark::State& state)
+{
+    const auto heightData = MakeHeightData(256);
+    const int n = static_cast<int>(state.range(0));
+
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                const glm::dvec2 position(2.0 * i / n - 1.0, 2.0 * j / n - 1.0);
+                sum += SampleElevation(position, heightData);
+            }
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+BENCHMARK(BM_SampleElevation)->Arg(64)->Arg(256);
+
+static void BM_ConvertLonLatToMeters(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<glm::dvec2> lonLats(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        lonLats[i] = glm::dvec2(-122.45 + 0.01 * i / n, 37.75 + 0.01 * i / n);
+    }
+
+    for (auto _ : state)
+    {
+        glm::dvec2 sum(0.0);
+
+        for (const auto& lonLat : lonLats)
+        {
+            sum += ConvertLonLatToMeters(lonLat);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ConvertLonLatToMeters)->Arg(1 << 16);
+
+static void BM_ComputeNormals(benchmark::State& state)
+{
+    PolygonMesh mesh;
+    const int subDiv = static_cast<int>(state.range(0));
+    const auto weighting = static_cast<NormalWeighting>(state.range(1));
+
+    // Terrain-like grid displaced by a heightmap
+    const auto heightData = MakeHeightData(256);
+
+    for (int y = 0; y <= subDiv; ++y)
+    {
+        for (int x = 0; x <= subDiv; ++x)
+        {
+            const glm::dvec2 p(2.0 * x / subDiv - 1.0, 2.0 * y / subDiv - 1.0);
+            mesh.AddVertex(glm::dvec3(p, SampleElevation(p, heightData) * 1e-3),
+                           glm::dvec3(0.0));
+        }
+    }
+
+    const unsigned int stride = subDiv + 1;
+
+    for (unsigned int y = 0; y < static_cast<unsigned int>(subDiv); ++y)
+    {
+        for (unsigned int x = 0; x < static_cast<unsigned int>(subDiv); ++x)
+        {
+            const unsigned int i = y * stride + x;
+            mesh.indices.insert(mesh.indices.end(),
+                                { i, i + 1, i + stride, i + 1, i + stride + 1,
+                                  i + stride });
+        }
+    }
+
+    for (auto _ : state)
+    {
+        ComputeNormals(mesh, weighting);
+        benchmark::DoNotOptimize(mesh.normals.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * mesh.indices.size() / 3);
+}
+BENCHMARK(BM_ComputeNormals)
+    ->Args({ 256, static_cast<int>(NormalWeighting::Uniform) })
+    ->Args({ 256, static_cast<int>(NormalWeighting::Area) })
+    ->Args({ 256, static_cast<int>(NormalWeighting::Angle) })
+    ->Unit(benchmark::kMillisecond);
\ No newline at end of file
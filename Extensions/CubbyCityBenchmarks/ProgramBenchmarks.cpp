@@ -0,0 +1,155 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "FixtureWriter.hpp"
+
+#include <CubbyCity/Commons/Macros.hpp>
+#include <CubbyCity/Programs/Program.hpp>
+#include <CubbyCity/Programs/ProgramOptions.hpp>
+
+#include <benchmark/benchmark.h>
+
+#if !defined(CUBBYCITY_WINDOWS)
+#include <sys/resource.h>
+#endif
+
+#include <map>
+#include <set>
+
+using namespace CubbyCity;
+
+namespace
+{
+CityGeneratorConfig MakeCity(int buildings, int footprintVertices, int roads,
+                             int roadPoints)
+{
+    CityGeneratorConfig city;
+    city.buildingsPerTile = buildings;
+    city.footprintVertices = footprintVertices;
+    city.roadsPerTile = roads;
+    city.roadPoints = roadPoints;
+
+    return city;
+}
+
+const std::vector<FixtureRegion> REGIONS = {
+    { "small", 19294, 19294, 24642, 24642, 16, MakeCity(200, 8, 10, 8) },
+    { "medium", 19293, 19295, 24641, 24643, 16, MakeCity(400, 8, 20, 8) },
+    { "dense", 19294, 19295, 24642, 24643, 16, MakeCity(3000, 12, 60, 32) },
+};
+
+std::string GetFixtureDir()
+{
+    return (std::filesystem::temp_directory_path() / "CubbyCityFixtures")
+        .string();
+}
+
+double GetPeakRSSMegabytes()
+{
+#if defined(CUBBYCITY_WINDOWS)
+    return 0.0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    // Kilobytes on Linux
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+ProgramConfig MakeConfig(const FixtureRegion& region)
+{
+    ProgramConfig config = ProgramOptions::GetDefaultConfig();
+    config.tileSource = GetFixtureDir();
+    config.tileX =
+        std::to_string(region.startX) + "/" + std::to_string(region.endX);
+    config.tileY =
+        std::to_string(region.startY) + "/" + std::to_string(region.endY);
+    config.tileZ = region.zoom;
+    config.fileName = GetFixtureDir() + "/" + region.name;
+    config.terrain = true;
+    config.buildings = true;
+    config.roads = true;
+    config.normals = true;
+
+    return config;
+}
+}  // namespace
+
+//! Runs the whole pipeline on generated tiles served from disk and reports
+//! the process peak RSS and the average time of each stage.
+static void BM_Process(benchmark::State& state)
+{
+    static std::set<size_t> writtenRegions;
+
+    const FixtureRegion& region = REGIONS[state.range(0)];
+
+    if (writtenRegions.insert(state.range(0)).second)
+    {
+        WriteRegionFixtures(GetFixtureDir(), region);
+    }
+
+    std::map<std::string, double> stageSeconds;
+
+    for (auto _ : state)
+    {
+        Program program(MakeConfig(region));
+        program.Process();
+
+        const nlohmann::json stages = program.GetProfiler().ToJSON()["stages"];
+        for (const auto& stage : stages.items())
+        {
+            stageSeconds[stage.key()] += stage.value()["seconds"].get<double>();
+        }
+    }
+
+    for (const auto& stage : stageSeconds)
+    {
+        state.counters[stage.first + "_ms"] = benchmark::Counter(
+            stage.second * 1e3, benchmark::Counter::kAvgIterations);
+    }
+
+    state.counters["peakRSS_MB"] = GetPeakRSSMegabytes();
+    state.SetLabel(region.name);
+}
+BENCHMARK(BM_Process)
+    ->DenseRange(0, static_cast<int>(REGIONS.size()) - 1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Runs the whole pipeline on a square of N x N generated tiles, skipping
+//! download and parsing, to see how building and export scale with the
+//! number of tiles. 32 x 32 tiles already take about 1.5 GB, so larger
+//! ranges are left to manual runs.
+static void BM_ProcessSynthetic(benchmark::State& state)
+{
+    const int side = static_cast<int>(state.range(0));
+
+    FixtureRegion region{ "synthetic", 19000, 19000 + side - 1,
+                          24000,       24000 + side - 1,
+                          16,          MakeCity(100, 8, 10, 8) };
+
+    ProgramConfig config = MakeConfig(region);
+    config.synthetic = true;
+    config.cityGenerator = region.city;
+    config.cityGenerator.heightmapSize = 64;
+    config.terrainSubdivision = 16;
+
+    for (auto _ : state)
+    {
+        Program program(config);
+        program.Process();
+    }
+
+    state.counters["tiles"] = side * side;
+    state.counters["peakRSS_MB"] = GetPeakRSSMegabytes();
+}
+BENCHMARK(BM_ProcessSynthetic)
+    ->Arg(4)
+    ->Arg(16)
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -4,37 +4,313 @@
 // personal capacity and are not conveying any rights to any intellectual
 // property of any third parties.
 
+#include <CubbyCity/Geometry/TileCache.hpp>
+#include <CubbyCity/Platform/CachingDownloader.hpp>
+#include <CubbyCity/Platform/DownloadUtils.hpp>
+#include <CubbyCity/Programs/Prefetcher.hpp>
 #include <CubbyCity/Programs/Program.hpp>
 #include <CubbyCity/Programs/ProgramConfig.hpp>
+#include <CubbyCity/Programs/ProgramOptions.hpp>
+#include <CubbyCity/Programs/TileServer.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace CubbyCity;
 
-int main()
+namespace
+{
+void PrintUsage()
+{
+    std::cout << "Usage: CubbyCityConsole [options]\n"
+                 "       CubbyCityConsole --job <file> [options]\n"
+                 "       CubbyCityConsole --serve <port> [options]\n\n"
+                 "A job file holds {\"defaults\": {...}, \"jobs\": [{...}]} "
+                 "with the option\nnames below as keys; command line options "
+                 "apply to every job.\n--serve answers GET /tile/z/x/y.obj and "
+                 "/region.obj on 127.0.0.1,\ntaking options as query "
+                 "parameters.\n--prefetch fills tileCacheDir with the tiles "
+                 "of the region or tile range\nat each prefetchZoom and "
+                 "prints the coverage as JSON.\nThe API key defaults to "
+                 "$NEXTZEN_API_KEY.\n\n"
+              << ProgramOptions::GetUsage();
+}
+
+//! Parses the port of --serve, in [1, 65535].
+unsigned short ParsePort(const std::string& value)
+{
+    size_t end = 0;
+    int port = 0;
+
+    try
+    {
+        port = std::stoi(value, &end);
+    }
+    catch (const std::exception&)
+    {
+        end = 0;
+    }
+
+    if (end == 0 || end != value.size() || port < 1 || port > 65535)
+    {
+        throw std::invalid_argument("Bad port for --serve: " + value);
+    }
+
+    return static_cast<unsigned short>(port);
+}
+
+//! Returns whether every payload ended up in the cache.
+bool Prefetch(const ProgramConfig& config)
+{
+    Prefetcher prefetcher(config);
+    const nlohmann::json report = prefetcher.Run();
+
+    std::cout << report.dump(4) << "\n";
+
+    if (!config.profileFile.empty())
+    {
+        prefetcher.GetProfiler().SaveJSON(config.profileFile);
+    }
+
+    if (!config.traceFile.empty())
+    {
+        prefetcher.GetProfiler().SaveChromeTrace(config.traceFile);
+    }
+
+    return report["failed"].empty();
+}
+
+//!
+//! Caches shared by the jobs of a job file. There is a downloader, with its
+//! payload cache, per tile source and download policy, so that every job
+//! gets the timeouts, retries and rate limit it asks for, and a cache of
+//! decoded tiles per tile source and endpoint.
+//!
+class JobCaches
 {
-    ProgramConfig config;
-    config.apiKey = "ZhvAFy8gTZSk6sPnAn_KwA";
-    config.tileX = "19294";
-    config.tileY = "24642";
-    config.tileZ = 16;
-    config.terrainSubdivision = 64;
-    config.terrainExtrusionScale = 1.0;
-    config.buildingsHeight = 0.0;
-    config.buildingsExtrusionScale = 1.0;
-    config.roadsHeight = 1.0;
-    config.roadsExtrusionWidth = 5.0;
-    config.pedestalHeight = 0.0;
-    config.offsetX = 0.0;
-    config.offsetY = 0.0;
-    config.terrain = false;
-    config.buildings = true;
-    config.roads = false;
-    config.pedestal = false;
-    config.normals = false;
-    config.splitMesh = false;
-    config.append = false;
-
-    Program program(config);
-    program.Process();
-
-    return 0;
+ public:
+    explicit JobCaches(const ProgramConfig& config)
+        : m_downloadCacheBytes(static_cast<size_t>(config.downloadCacheSize)
+                               << 20),
+          m_decodedCacheBytes(static_cast<size_t>(config.decodedCacheSize)
+                              << 20)
+    {
+        // Do nothing
+    }
+
+    std::shared_ptr<IDownloader> GetDownloader(const ProgramConfig& config)
+    {
+        const DownloadPolicy policy = GetDownloadPolicy(config);
+
+        for (const auto& entry : m_downloaders)
+        {
+            if (entry.tileSource == config.tileSource && entry.policy == policy)
+            {
+                return entry.downloader;
+            }
+        }
+
+        m_downloaders.push_back(
+            { config.tileSource, policy,
+              std::make_shared<CachingDownloader>(CreateDownloader(config),
+                                                  m_downloadCacheBytes) });
+
+        return m_downloaders.back().downloader;
+    }
+
+    std::shared_ptr<TileCache> GetTileCache(const ProgramConfig& config)
+    {
+        auto& tileCache =
+            m_tileCaches[config.tileSource + "\n" + config.tileEndpoint];
+
+        if (!tileCache)
+        {
+            tileCache = std::make_shared<TileCache>(m_decodedCacheBytes);
+        }
+
+        return tileCache;
+    }
+
+ private:
+    struct Downloader
+    {
+        std::string tileSource;
+        DownloadPolicy policy;
+        std::shared_ptr<IDownloader> downloader;
+    };
+
+    size_t m_downloadCacheBytes;
+    size_t m_decodedCacheBytes;
+    std::vector<Downloader> m_downloaders;
+    std::map<std::string, std::shared_ptr<TileCache>> m_tileCaches;
+};
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    ProgramConfig config = ProgramOptions::GetDefaultConfig();
+    std::string jobFile;
+    unsigned short serverPort = 0;
+
+    if (const char* apiKey = std::getenv("NEXTZEN_API_KEY"))
+    {
+        config.apiKey = apiKey;
+    }
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+
+            if (arg == "-h" || arg == "--help")
+            {
+                PrintUsage();
+                return 0;
+            }
+
+            if (arg.compare(0, 2, "--") != 0)
+            {
+                throw std::invalid_argument("Unexpected argument: " + arg);
+            }
+
+            std::string name = arg.substr(2);
+            std::string value;
+            bool hasValue = false;
+
+            const size_t equal = name.find('=');
+            if (equal != std::string::npos)
+            {
+                value = name.substr(equal + 1);
+                name.resize(equal);
+                hasValue = true;
+            }
+
+            if (name != "job" && name != "serve" &&
+                !ProgramOptions::Has(name))
+            {
+                throw std::invalid_argument("Unknown option: --" + name);
+            }
+
+            if (!hasValue)
+            {
+                if (ProgramOptions::IsFlag(name))
+                {
+                    value = "true";
+                }
+                else if (i + 1 < argc)
+                {
+                    value = argv[++i];
+                }
+                else
+                {
+                    throw std::invalid_argument("Missing value for --" +
+                                                name);
+                }
+            }
+
+            if (name == "job")
+            {
+                jobFile = value;
+            }
+            else if (name == "serve")
+            {
+                serverPort = ParsePort(value);
+            }
+            else
+            {
+                ProgramOptions::Set(config, name, value);
+            }
+        }
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << e.what() << "\n\n";
+        PrintUsage();
+        return 1;
+    }
+
+    if (serverPort > 0)
+    {
+        try
+        {
+            TileServer server(config, CreateDownloader(config),
+                              static_cast<size_t>(config.serverCacheSize)
+                                  << 20);
+            server.Run(serverPort);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (jobFile.empty())
+    {
+        try
+        {
+            if (config.prefetch)
+            {
+                return Prefetch(config) ? 0 : 1;
+            }
+
+            Program program(config);
+            program.Process();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    // Jobs run one after another and share the fetched and decoded tiles
+    JobCaches caches(config);
+
+    std::vector<ProgramConfig> jobs;
+
+    try
+    {
+        jobs = ProgramOptions::LoadJobFile(jobFile, config);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    int result = 0;
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        try
+        {
+            if (jobs[i].prefetch)
+            {
+                result = Prefetch(jobs[i]) ? result : 1;
+                continue;
+            }
+
+            Program program(jobs[i], caches.GetDownloader(jobs[i]),
+                            caches.GetTileCache(jobs[i]));
+            program.Process();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Job " << i << " failed: " << e.what() << "\n";
+            result = 1;
+        }
+    }
+
+    return result;
 }
\ No newline at end of file
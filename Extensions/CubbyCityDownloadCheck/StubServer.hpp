@@ -0,0 +1,181 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_STUB_SERVER_HPP
+#define CUBBYCITY_STUB_SERVER_HPP
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CubbyCity
+{
+//! Answer of the stub server to one request.
+struct StubResponse
+{
+    int status = 200;
+    std::string body;
+    std::string retryAfter;
+
+    //! Seconds to wait before answering.
+    double delay = 0.0;
+};
+
+//!
+//! HTTP server on an ephemeral loopback port answering each path with a
+//! script of responses, one per request, the last one repeating. Every
+//! connection is served on its own thread and closed after one answer.
+//!
+class StubServer
+{
+ public:
+    StubServer()
+    {
+        m_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+
+        if (m_socket < 0 ||
+            bind(m_socket, reinterpret_cast<sockaddr*>(&address), length) !=
+                0 ||
+            listen(m_socket, 16) != 0 ||
+            getsockname(m_socket, reinterpret_cast<sockaddr*>(&address),
+                        &length) != 0)
+        {
+            throw std::runtime_error("Failed to start the stub server");
+        }
+
+        m_port = ntohs(address.sin_port);
+        m_thread = std::thread([this] { Accept(); });
+    }
+
+    StubServer(const StubServer&) = delete;
+    StubServer& operator=(const StubServer&) = delete;
+
+    ~StubServer()
+    {
+        shutdown(m_socket, SHUT_RDWR);
+        close(m_socket);
+        m_thread.join();
+
+        for (auto& client : m_clients)
+        {
+            client.join();
+        }
+    }
+
+    void SetScript(const std::string& path,
+                   std::vector<StubResponse> responses)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scripts[path] = std::move(responses);
+    }
+
+    std::string GetURL(const std::string& path) const
+    {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    //! Returns the number of requests made for \p path.
+    size_t GetNumRequests(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counts[path];
+    }
+
+ private:
+    void Accept()
+    {
+        while (true)
+        {
+            const int client = accept(m_socket, nullptr, nullptr);
+            if (client < 0)
+            {
+                return;
+            }
+
+            m_clients.emplace_back([this, client] { Serve(client); });
+        }
+    }
+
+    void Serve(int client)
+    {
+        std::string request;
+        char buffer[4096];
+
+        while (request.find("\r\n\r\n") == std::string::npos)
+        {
+            const ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+            if (n <= 0)
+            {
+                close(client);
+                return;
+            }
+            request.append(buffer, static_cast<size_t>(n));
+        }
+
+        std::istringstream requestLine(request);
+        std::string method, path;
+        requestLine >> method >> path;
+
+        StubResponse response;
+        response.status = 404;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const size_t index = m_counts[path]++;
+            const auto script = m_scripts.find(path);
+
+            if (script != m_scripts.end() && !script->second.empty())
+            {
+                response = script->second[std::min(
+                    index, script->second.size() - 1)];
+            }
+        }
+
+        std::this_thread::sleep_for(
+            std::chrono::duration<double>(response.delay));
+
+        std::ostringstream answer;
+        answer << "HTTP/1.1 " << response.status << " Stub\r\n"
+               << "Content-Length: " << response.body.size() << "\r\n";
+        if (!response.retryAfter.empty())
+        {
+            answer << "Retry-After: " << response.retryAfter << "\r\n";
+        }
+        answer << "Connection: close\r\n\r\n" << response.body;
+
+        const std::string bytes = answer.str();
+        send(client, bytes.data(), bytes.size(), 0);
+        close(client);
+    }
+
+    int m_socket = -1;
+    unsigned short m_port = 0;
+
+    std::thread m_thread;
+    std::vector<std::thread> m_clients;
+
+    std::mutex m_mutex;
+    std::map<std::string, std::vector<StubResponse>> m_scripts;
+    std::map<std::string, size_t> m_counts;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_STUB_SERVER_HPP
\ No newline at end of file
@@ -0,0 +1,154 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Platform/DownloadUtils.hpp>
+
+#include "StubServer.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <iostream>
+#include <string>
+
+using namespace CubbyCity;
+
+namespace
+{
+struct Check
+{
+    std::string path;
+    std::vector<StubResponse> script;
+
+    //! Receives the result, the requests made and the elapsed seconds, and
+    //! returns what is wrong, if anything.
+    std::function<std::string(const DownloadResult&, const std::string&,
+                              size_t, double)>
+        verify;
+};
+
+StubResponse Answer(int status, std::string body = "",
+                    std::string retryAfter = "", double delay = 0.0)
+{
+    StubResponse response;
+    response.status = status;
+    response.body = std::move(body);
+    response.retryAfter = std::move(retryAfter);
+    response.delay = delay;
+
+    return response;
+}
+}  // namespace
+
+//! Runs the network downloader of the platform, with its retries, against
+//! a local stub server and checks how each kind of failure is handled.
+//! Exits with a non-zero status when a check fails.
+int main()
+{
+    // The downloader hangs up on the slow answer before it is sent
+    std::signal(SIGPIPE, SIG_IGN);
+
+    DownloadPolicy policy;
+    policy.timeout = 1.0;
+    policy.connectTimeout = 1.0;
+    policy.retries = 2;
+    policy.retryDelay = 0.01;
+    policy.maxRetryDelay = 5.0;
+
+    const std::vector<Check> checks = {
+        { "/503",
+          { Answer(503), Answer(200, "tile") },
+          [](const DownloadResult& result, const std::string& body,
+             size_t requests, double) -> std::string {
+              if (!result.ok || body != "tile" || requests != 2)
+              {
+                  return "a 503 is retried once and then succeeds";
+              }
+              return "";
+          } },
+        { "/429",
+          { Answer(429, "", "1"), Answer(200, "tile") },
+          [](const DownloadResult& result, const std::string& body,
+             size_t requests, double seconds) -> std::string {
+              if (!result.ok || body != "tile" || requests != 2)
+              {
+                  return "a 429 is retried and then succeeds";
+              }
+              if (seconds < 1.0)
+              {
+                  return "the retry waits for Retry-After";
+              }
+              return "";
+          } },
+        { "/429-long",
+          { Answer(429, "", "86400"), Answer(200, "tile") },
+          [](const DownloadResult& result, const std::string&,
+             size_t requests, double seconds) -> std::string {
+              if (result.ok || requests != 1 || seconds > 1.0)
+              {
+                  return "a Retry-After beyond maxRetryDelay fails at once";
+              }
+              return "";
+          } },
+        { "/timeout",
+          { Answer(200, "late", "", 3.0), Answer(200, "tile") },
+          [](const DownloadResult& result, const std::string& body,
+             size_t requests, double seconds) -> std::string {
+              if (!result.ok || body != "tile" || requests != 2)
+              {
+                  return "a timed out request is retried";
+              }
+              if (seconds > 2.5)
+              {
+                  return "the request times out after the policy timeout";
+              }
+              return "";
+          } },
+        { "/404",
+          { Answer(404), Answer(200, "tile") },
+          [](const DownloadResult& result, const std::string&,
+             size_t requests, double) -> std::string {
+              if (result.ok || result.transient || result.status != 404 ||
+                  requests != 1)
+              {
+                  return "a 404 fails at once without a retry";
+              }
+              return "";
+          } },
+    };
+
+    StubServer server;
+    const auto downloader = CreateDownloader("", policy);
+    int failures = 0;
+
+    for (const auto& check : checks)
+    {
+        server.SetScript(check.path, check.script);
+
+        const auto start = std::chrono::steady_clock::now();
+        std::string body;
+        const DownloadResult result =
+            downloader->Fetch(body, server.GetURL(check.path));
+        const double seconds = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+
+        const std::string error = check.verify(
+            result, body, server.GetNumRequests(check.path), seconds);
+
+        if (error.empty())
+        {
+            std::cout << "PASS " << check.path << "\n";
+        }
+        else
+        {
+            std::cout << "FAIL " << check.path << ": " << error << "\n";
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
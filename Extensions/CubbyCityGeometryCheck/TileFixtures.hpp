@@ -0,0 +1,110 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_TILE_FIXTURES_HPP
+#define CUBBYCITY_TILE_FIXTURES_HPP
+
+#include <CubbyCity/Geometry/GeometryUtils.hpp>
+#include <CubbyCity/Geometry/Tile.hpp>
+#include <CubbyCity/Platform/LocalDownloader.hpp>
+#include <CubbyCity/Platform/TileURLs.hpp>
+
+#include <json/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace CubbyCity
+{
+//! Converts \p point from the tile space of \p tile to GeoJSON lon/lat.
+inline nlohmann::json ToLonLat(const Tile& tile, const glm::dvec2& point)
+{
+    const glm::dvec2 meters(point.x / tile.invScale + tile.tileOrigin.x,
+                            point.y / tile.invScale + tile.tileOrigin.y);
+    const glm::dvec2 lonLat = ConvertMetersToLonLat(meters);
+
+    return { lonLat.x, lonLat.y };
+}
+
+//! Hand written vector tile, with coordinates given in the tile space of
+//! the tile it is written for.
+class VectorTileFixture
+{
+ public:
+    explicit VectorTileFixture(const Tile& tile) : m_tile(tile)
+    {
+        // Do nothing
+    }
+
+    //! Adds a building with one closed ring.
+    void AddBuilding(const std::vector<glm::dvec2>& ring, double height)
+    {
+        nlohmann::json coordinates = nlohmann::json::array();
+        for (const auto& point : ring)
+        {
+            coordinates.push_back(ToLonLat(m_tile, point));
+        }
+        coordinates.push_back(ToLonLat(m_tile, ring.front()));
+
+        AddFeature("buildings", { { "type", "Polygon" },
+                                  { "coordinates", { coordinates } } },
+                   { { "height", height } });
+    }
+
+    void AddRoad(const std::vector<glm::dvec2>& line)
+    {
+        nlohmann::json coordinates = nlohmann::json::array();
+        for (const auto& point : line)
+        {
+            coordinates.push_back(ToLonLat(m_tile, point));
+        }
+
+        AddFeature("roads",
+                   { { "type", "LineString" }, { "coordinates", coordinates } },
+                   nlohmann::json::object());
+    }
+
+    //! Writes the tile under \p rootDir, laid out as LocalDownloader expects.
+    void Write(const std::string& rootDir) const
+    {
+        const std::string path = LocalDownloader(rootDir).GetFilePath(
+            GetVectorTileURL(m_tile, ""));
+        std::filesystem::create_directories(
+            std::filesystem::path(path).parent_path());
+
+        std::ofstream file(path);
+        file << m_layers.dump();
+    }
+
+ private:
+    void AddFeature(const std::string& layer, nlohmann::json geometry,
+                    nlohmann::json properties)
+    {
+        m_layers[layer]["features"].push_back(
+            { { "type", "Feature" },
+              { "properties", std::move(properties) },
+              { "geometry", std::move(geometry) } });
+    }
+
+    Tile m_tile;
+    nlohmann::json m_layers = nlohmann::json::object();
+};
+
+//! Returns the corners of the axis aligned square of half side \p radius
+//! around \p center, counter clockwise.
+inline std::vector<glm::dvec2> MakeSquare(const glm::dvec2& center,
+                                          double radius)
+{
+    return { center + glm::dvec2(-radius, -radius),
+             center + glm::dvec2(radius, -radius),
+             center + glm::dvec2(radius, radius),
+             center + glm::dvec2(-radius, radius) };
+}
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_TILE_FIXTURES_HPP
\ No newline at end of file
@@ -0,0 +1,297 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/Parallel.hpp>
+#include <CubbyCity/Geometry/Geometry.hpp>
+#include <CubbyCity/Geometry/TileCover.hpp>
+#include <CubbyCity/Programs/ProgramOptions.hpp>
+
+#include "TileFixtures.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CubbyCity;
+
+namespace
+{
+//! Two tiles side by side, west then east, at zoom 16.
+const Tile WEST_TILE(19294, 24642, 16);
+const Tile EAST_TILE(19295, 24642, 16);
+
+struct Check
+{
+    std::string name;
+
+    //! Returns what is wrong, if anything.
+    std::function<std::string(const std::string& dir)> run;
+};
+
+ProgramConfig MakeConfig(const std::string& dir)
+{
+    ProgramConfig config = ProgramOptions::GetDefaultConfig();
+    config.tileSource = dir;
+    config.tileX = std::to_string(WEST_TILE.x) + "/" +
+                   std::to_string(EAST_TILE.x);
+    config.tileY = std::to_string(WEST_TILE.y);
+    config.tileZ = WEST_TILE.z;
+
+    return config;
+}
+
+//! Builds the tiles of \p config and returns them as OBJ, and the Chrome
+//! trace of the build in \p trace when given.
+std::string BuildOBJ(const ProgramConfig& config,
+                     nlohmann::json* trace = nullptr)
+{
+    Geometry geometry(config);
+    geometry.GetProfiler().EnableTrace(trace != nullptr);
+    geometry.ParseTiles(SelectTiles(config, config.tileZ), config.tileZ);
+    geometry.DownloadData(config.apiKey, config.terrain,
+                          config.terrainExtrusionScale, config.buildings,
+                          config.roads);
+    geometry.BuildMeshes();
+
+    std::ostringstream stream;
+    geometry.ExportToStream(stream);
+
+    if (trace)
+    {
+        *trace = geometry.GetProfiler().ToChromeTrace();
+    }
+
+    return stream.str();
+}
+
+//! Returns the threads of the spans of \p category named \p name.
+std::set<int> GetTraceThreads(const nlohmann::json& trace,
+                              const std::string& category,
+                              const std::string& name)
+{
+    std::set<int> threads;
+
+    for (const auto& event : trace["traceEvents"])
+    {
+        if (event.value("cat", "") == category && event["name"] == name)
+        {
+            threads.insert(event["tid"].get<int>());
+        }
+    }
+
+    return threads;
+}
+
+//! Returns the names of the OBJ groups, once per "g" statement.
+std::vector<std::string> GetGroups(const std::string& obj)
+{
+    std::vector<std::string> groups;
+    std::istringstream stream(obj);
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        if (line.compare(0, 2, "g ") == 0)
+        {
+            groups.push_back(line.substr(2));
+        }
+    }
+
+    return groups;
+}
+
+//! Feature ids restart in every tile and layer; a merged export must still
+//! give every feature a group of its own.
+std::string CheckFeatureGroups(const std::string& dir)
+{
+    for (const Tile& tile : { WEST_TILE, EAST_TILE })
+    {
+        VectorTileFixture fixture(tile);
+        fixture.AddBuilding(MakeSquare({ -0.5, -0.5 }, 0.1), 10.0);
+        fixture.AddBuilding(MakeSquare({ 0.5, 0.5 }, 0.1), 20.0);
+        fixture.AddRoad({ { -0.8, 0.0 }, { 0.8, 0.0 } });
+        fixture.Write(dir);
+    }
+
+    for (const bool batch : { false, true })
+    {
+        ProgramConfig config = MakeConfig(dir);
+        config.roads = true;
+        config.featureIds = true;
+        config.batchMeshes = batch;
+
+        const auto groups = GetGroups(BuildOBJ(config));
+        const std::set<std::string> names(groups.begin(), groups.end());
+
+        if (groups.size() != 6 || names.size() != 6)
+        {
+            return std::to_string(names.size()) +
+                   " groups for 6 features with batchMeshes=" +
+                   (batch ? "true" : "false");
+        }
+    }
+
+    return "";
+}
+
+//! A building across the side of two tiles comes in both, each copy cut
+//! to the buffer of its tile, and is built by exactly one of them.
+std::string CheckStraddlingBuildings(const std::string& dir)
+{
+    // In the tile space of the west tile: one building mostly west of the
+    // side, whose copies have centroids on either side of it, and one with
+    // its west wall on the side
+    const std::vector<std::pair<double, double>> spans = { { 0.2, 1.6 },
+                                                           { 1.0, 1.3 } };
+    const double buffer = 0.1;
+
+    for (const Tile& tile : { WEST_TILE, EAST_TILE })
+    {
+        const double offset = 2.0 * (WEST_TILE.x - tile.x);
+
+        VectorTileFixture fixture(tile);
+        for (const auto& span : spans)
+        {
+            const double west = std::max(span.first + offset, -1.0 - buffer);
+            const double east = std::min(span.second + offset, 1.0 + buffer);
+            fixture.AddBuilding({ { west, -0.3 },
+                                  { east, -0.3 },
+                                  { east, 0.3 },
+                                  { west, 0.3 } },
+                                10.0);
+        }
+        fixture.Write(dir);
+    }
+
+    ProgramConfig config = MakeConfig(dir);
+    config.clipToTile = true;
+    config.featureIds = true;
+
+    size_t numBuildings = 0;
+    for (const auto& group : GetGroups(BuildOBJ(config)))
+    {
+        if (group.find("_buildings_") != std::string::npos)
+        {
+            ++numBuildings;
+        }
+    }
+
+    if (numBuildings != spans.size())
+    {
+        return std::to_string(numBuildings) + " buildings built for " +
+               std::to_string(spans.size());
+    }
+
+    return "";
+}
+
+//! Chunks of parallel loops show up in the trace on the thread that ran
+//! them, both for the mesh kernels and for the pool itself.
+std::string CheckWorkerTrace(const std::string& dir)
+{
+    ThreadPool::GetInstance().Resize(4);
+
+    // A batched mesh of a few thousand buildings spans several chunks;
+    // their normals are recomputed after simplify
+    for (const Tile& tile : { WEST_TILE, EAST_TILE })
+    {
+        VectorTileFixture fixture(tile);
+        for (int i = 0; i < 40; ++i)
+        {
+            for (int j = 0; j < 40; ++j)
+            {
+                fixture.AddBuilding(
+                    MakeSquare({ -0.95 + 0.048 * i, -0.95 + 0.048 * j }, 0.01),
+                    10.0);
+            }
+        }
+        fixture.Write(dir);
+    }
+
+    ProgramConfig config = MakeConfig(dir);
+    config.normals = true;
+    config.batchMeshes = true;
+    config.simplify = true;
+
+    nlohmann::json trace;
+    BuildOBJ(config, &trace);
+
+    if (GetTraceThreads(trace, "worker", "vertexNormals").empty())
+    {
+        return "no vertexNormals spans in the trace";
+    }
+
+    // Chunks long enough for every worker to wake up and take one
+    Profiler profiler;
+    profiler.EnableTrace(true);
+    ParallelRangeFor(
+        0, 4,
+        [](size_t, size_t) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        },
+        1, &profiler, "sleep");
+
+    const size_t numThreads =
+        GetTraceThreads(profiler.ToChromeTrace(), "worker", "sleep").size();
+    if (numThreads < 2)
+    {
+        return "worker spans on " + std::to_string(numThreads) + " thread";
+    }
+
+    return "";
+}
+}  // namespace
+
+//! Builds hand written tiles through the geometry pipeline and checks the
+//! meshes where tiles meet. Exits with a non-zero status when a check fails.
+int main()
+{
+    const std::vector<Check> checks = {
+        { "featureGroups", CheckFeatureGroups },
+        { "straddlingBuildings", CheckStraddlingBuildings },
+        { "workerTrace", CheckWorkerTrace },
+    };
+
+    const std::filesystem::path root =
+        std::filesystem::temp_directory_path() / "CubbyCityGeometryCheck";
+    int failures = 0;
+
+    for (const auto& check : checks)
+    {
+        const std::filesystem::path dir = root / check.name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+
+        std::string error;
+        try
+        {
+            error = check.run(dir.string());
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+
+        if (error.empty())
+        {
+            std::cout << "PASS " << check.name << "\n";
+        }
+        else
+        {
+            std::cout << "FAIL " << check.name << ": " << error << "\n";
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_FAST_MATH_HPP
+#define CUBBYCITY_FAST_MATH_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace CubbyCity
+{
+constexpr static double LN_2 = 0.69314718055994530942;
+constexpr static double SQRT_2 = 1.41421356237309504880;
+
+//! Branch-free sine for |x| <= pi / 2, so that loops calling it can be
+//! vectorized. Odd Taylor polynomial of degree 19, absolute error below 1e-16.
+inline double FastSin(double x)
+{
+    const double x2 = x * x;
+
+    double p = -1.0 / 121645100408832000.0;
+    p = p * x2 + 1.0 / 355687428096000.0;
+    p = p * x2 - 1.0 / 1307674368000.0;
+    p = p * x2 + 1.0 / 6227020800.0;
+    p = p * x2 - 1.0 / 39916800.0;
+    p = p * x2 + 1.0 / 362880.0;
+    p = p * x2 - 1.0 / 5040.0;
+    p = p * x2 + 1.0 / 120.0;
+    p = p * x2 - 1.0 / 6.0;
+    p = p * x2 + 1.0;
+
+    return x * p;
+}
+
+//! Branch-free natural logarithm for positive normal numbers, so that loops
+//! calling it can be vectorized. The mantissa is reduced to
+//! [sqrt(0.5), sqrt(2)) and ln(m) = 2 * atanh((m - 1) / (m + 1)) is expanded
+//! up to degree 19, relative error below 1e-16.
+inline double FastLog(double x)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    double exponent =
+        static_cast<double>(static_cast<std::int64_t>((bits >> 52) & 0x7ff) -
+                            1023);
+    bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+
+    double m;
+    std::memcpy(&m, &bits, sizeof(m));
+
+    const bool reduce = m > SQRT_2;
+    m = reduce ? m * 0.5 : m;
+    exponent += reduce ? 1.0 : 0.0;
+
+    const double z = (m - 1.0) / (m + 1.0);
+    const double z2 = z * z;
+
+    double p = 1.0 / 19.0;
+    p = p * z2 + 1.0 / 17.0;
+    p = p * z2 + 1.0 / 15.0;
+    p = p * z2 + 1.0 / 13.0;
+    p = p * z2 + 1.0 / 11.0;
+    p = p * z2 + 1.0 / 9.0;
+    p = p * z2 + 1.0 / 7.0;
+    p = p * z2 + 1.0 / 5.0;
+    p = p * z2 + 1.0 / 3.0;
+    p = p * z2 + 1.0;
+
+    return 2.0 * z * p + exponent * LN_2;
+}
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_FAST_MATH_HPP
\ No newline at end of file
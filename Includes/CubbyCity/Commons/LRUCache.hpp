@@ -0,0 +1,124 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_LRU_CACHE_HPP
+#define CUBBYCITY_LRU_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+namespace CubbyCity
+{
+//!
+//! Least recently used cache bounded by the total cost of its entries (e.g.
+//! bytes). Entries are evicted from the least recently used end until the
+//! total fits the capacity; an entry costing more than the capacity is not
+//! stored at all. Safe to use from several threads.
+//!
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache
+{
+ public:
+    explicit LRUCache(size_t capacity) : m_capacity(capacity)
+    {
+        // Do nothing
+    }
+
+    //! Copies the value of \p key into \p out and marks it as recently used.
+    bool Get(const Key& key, Value& out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return false;
+        }
+
+        m_order.splice(m_order.begin(), m_order, it->second);
+        out = std::get<1>(*it->second);
+
+        return true;
+    }
+
+    void Put(const Key& key, Value value, size_t cost)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            m_size -= std::get<2>(*it->second);
+            m_order.erase(it->second);
+            m_entries.erase(it);
+        }
+
+        if (cost > m_capacity)
+        {
+            return;
+        }
+
+        while (m_size + cost > m_capacity)
+        {
+            m_size -= std::get<2>(m_order.back());
+            m_entries.erase(std::get<0>(m_order.back()));
+            m_order.pop_back();
+        }
+
+        m_order.emplace_front(key, std::move(value), cost);
+        m_entries.emplace(key, m_order.begin());
+        m_size += cost;
+    }
+
+    void Erase(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            m_size -= std::get<2>(*it->second);
+            m_order.erase(it->second);
+            m_entries.erase(it);
+        }
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_entries.clear();
+        m_order.clear();
+        m_size = 0;
+    }
+
+    size_t GetSize() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_size;
+    }
+
+    size_t GetCapacity() const
+    {
+        return m_capacity;
+    }
+
+ private:
+    using Entry = std::tuple<Key, Value, size_t>;
+
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_order;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash>
+        m_entries;
+    size_t m_capacity;
+    size_t m_size = 0;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_LRU_CACHE_HPP
\ No newline at end of file
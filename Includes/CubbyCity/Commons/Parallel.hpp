@@ -0,0 +1,255 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_PARALLEL_HPP
+#define CUBBYCITY_PARALLEL_HPP
+
+#include <CubbyCity/Programs/Profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CubbyCity
+{
+//! Elements below which a range is not worth splitting across threads.
+constexpr size_t DEFAULT_GRAIN_SIZE = 4096;
+
+inline unsigned int GetMaxNumberOfThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+//!
+//! Worker threads started once and shared by every ParallelRangeFor, so
+//! that small parallel loops do not pay for creating threads.
+//!
+//! One loop runs on the pool at a time. A loop started while the pool is
+//! busy, or from one of its workers, runs on the calling thread instead.
+//! Tasks must not throw.
+//!
+class ThreadPool
+{
+ public:
+    static ThreadPool& GetInstance()
+    {
+        static ThreadPool pool(GetMaxNumberOfThreads() - 1);
+        return pool;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        StopWorkers();
+    }
+
+    //! Restarts the pool with \p numThreads threads, the caller included,
+    //! once the running loop, if any, is done.
+    void Resize(unsigned int numThreads)
+    {
+        std::lock_guard<std::mutex> running(m_runMutex);
+
+        StopWorkers();
+        StartWorkers(std::max(1u, numThreads) - 1);
+    }
+
+    //! Returns the number of threads running a loop, the caller included.
+    size_t GetNumThreads() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    //! Calls task(i) for every i in [0, count) on the workers and the
+    //! calling thread, and returns once all calls are done.
+    void Run(size_t count, const std::function<void(size_t)>& task)
+    {
+        std::unique_lock<std::mutex> running(m_runMutex, std::try_to_lock);
+
+        if (!running.owns_lock() || IsWorker() || m_workers.empty())
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                task(i);
+            }
+
+            return;
+        }
+
+        Job job(task, count);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+        }
+
+        m_wakeUp.notify_all();
+        job.Work();
+
+        // Every index is taken, wait for the workers still running one
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&job] { return job.numWorkers == 0; });
+        m_job = nullptr;
+    }
+
+ private:
+    struct Job
+    {
+        Job(const std::function<void(size_t)>& _task, size_t _count)
+            : task(_task), count(_count)
+        {
+            // Do nothing
+        }
+
+        bool HasWork() const
+        {
+            return next.load() < count;
+        }
+
+        void Work()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                task(i);
+            }
+        }
+
+        const std::function<void(size_t)>& task;
+        const size_t count;
+        std::atomic<size_t> next{ 0 };
+        size_t numWorkers = 0;
+    };
+
+    explicit ThreadPool(unsigned int numWorkers)
+    {
+        StartWorkers(numWorkers);
+    }
+
+    void StartWorkers(unsigned int numWorkers)
+    {
+        m_workers.reserve(numWorkers);
+
+        for (unsigned int i = 0; i < numWorkers; ++i)
+        {
+            m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    void StopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wakeUp.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+
+        m_workers.clear();
+        m_stop = false;
+    }
+
+    static bool& IsWorker()
+    {
+        thread_local bool isWorker = false;
+        return isWorker;
+    }
+
+    void WorkerLoop()
+    {
+        IsWorker() = true;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true)
+        {
+            m_wakeUp.wait(lock, [this] {
+                return m_stop || (m_job != nullptr && m_job->HasWork());
+            });
+
+            if (m_stop)
+            {
+                return;
+            }
+
+            Job* job = m_job;
+            ++job->numWorkers;
+
+            lock.unlock();
+            job->Work();
+            lock.lock();
+
+            if (--job->numWorkers == 0)
+            {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_done;
+    Job* m_job = nullptr;
+    bool m_stop = false;
+};
+
+//! Splits [begin, end) into contiguous chunks of at least \p grainSize
+//! elements and calls func(chunkBegin, chunkEnd) for each chunk on the
+//! shared ThreadPool. Runs on the calling thread when the range fits in one
+//! chunk. When \p profiler traces, every chunk run in parallel is recorded
+//! as a span named \p name on the thread that ran it.
+template <typename Function>
+void ParallelRangeFor(size_t begin, size_t end, const Function& func,
+                      size_t grainSize = DEFAULT_GRAIN_SIZE,
+                      Profiler* profiler = nullptr,
+                      const char* name = "chunk")
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    ThreadPool& pool = ThreadPool::GetInstance();
+
+    const size_t n = end - begin;
+    const size_t numChunks =
+        std::min<size_t>(pool.GetNumThreads(),
+                         (n + grainSize - 1) / std::max<size_t>(grainSize, 1));
+
+    if (numChunks <= 1)
+    {
+        func(begin, end);
+        return;
+    }
+
+    const size_t chunkSize = (n + numChunks - 1) / numChunks;
+
+    pool.Run(numChunks, [&](size_t c) {
+        const size_t chunkBegin = begin + c * chunkSize;
+        const size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+
+        if (chunkBegin < chunkEnd)
+        {
+            ScopedTrace trace(profiler, name, "worker");
+            func(chunkBegin, chunkEnd);
+        }
+    });
+}
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_PARALLEL_HPP
\ No newline at end of file
@@ -0,0 +1,95 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_TOKEN_BUCKET_HPP
+#define CUBBYCITY_TOKEN_BUCKET_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace CubbyCity
+{
+//!
+//! Token bucket rate limiter: tokens accrue at \p rate per second up to
+//! \p burst, and each request takes one. A caller that finds the bucket empty
+//! takes a token in advance and sleeps until it is due, so waiting callers
+//! are served in order without holding the lock. A non-positive rate does
+//! not limit. Safe to use from several threads.
+//!
+class TokenBucket
+{
+ public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(double rate, double burst)
+        : m_rate(rate),
+          m_burst(std::max(burst, 1.0)),
+          m_tokens(m_burst),
+          m_last(Clock::now()),
+          m_pausedUntil(m_last)
+    {
+        // Do nothing
+    }
+
+    //! Blocks until a token is available and takes it.
+    void Acquire()
+    {
+        Clock::duration wait = Clock::duration::zero();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            const auto now = Clock::now();
+
+            if (m_rate > 0.0)
+            {
+                const std::chrono::duration<double> elapsed = now - m_last;
+                m_tokens =
+                    std::min(m_burst, m_tokens + elapsed.count() * m_rate);
+                m_last = now;
+                m_tokens -= 1.0;
+
+                if (m_tokens < 0.0)
+                {
+                    wait = std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(-m_tokens / m_rate));
+                }
+            }
+
+            wait = std::max(wait, m_pausedUntil - now);
+        }
+
+        if (wait > Clock::duration::zero())
+        {
+            std::this_thread::sleep_for(wait);
+        }
+    }
+
+    //! Hands out no token for the next \p seconds, e.g. when the server asked
+    //! to slow down.
+    void Pause(double seconds)
+    {
+        const auto duration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(seconds));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_pausedUntil = std::max(m_pausedUntil, Clock::now() + duration);
+    }
+
+ private:
+    std::mutex m_mutex;
+    double m_rate;
+    double m_burst;
+    double m_tokens;
+    Clock::time_point m_last;
+    Clock::time_point m_pausedUntil;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_TOKEN_BUCKET_HPP
\ No newline at end of file
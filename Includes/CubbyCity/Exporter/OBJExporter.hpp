@@ -18,6 +18,14 @@ class OBJExporter : public IExporter
               std::vector<std::unique_ptr<PolygonMesh>>& meshes, double offsetX,
               double offsetY, bool append, bool normals) override;
 
+    //! Writes the meshes to \p file, numbering vertices from
+    //! \p indexOffset + 1.
+    void Write(std::ostream& file, const std::string& objectName,
+               bool splitMeshes,
+               const std::vector<std::unique_ptr<PolygonMesh>>& meshes,
+               double offsetX, double offsetY, bool normals,
+               size_t indexOffset = 0) const;
+
  private:
     void AddPositions(std::ostream& file, const PolygonMesh& mesh,
                       double offsetX, double offsetY) const;
@@ -0,0 +1,66 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_CITY_GENERATOR_HPP
+#define CUBBYCITY_CITY_GENERATOR_HPP
+
+#include <CubbyCity/Geometry/GeometryData.hpp>
+#include <CubbyCity/Geometry/Tile.hpp>
+
+#include <memory>
+
+namespace CubbyCity
+{
+struct CityGeneratorConfig
+{
+    unsigned int seed = 1;
+
+    int buildingsPerTile = 400;
+    int footprintVertices = 8;
+    int roadsPerTile = 20;
+    int roadPoints = 16;
+
+    int heightmapSize = 260;
+    double terrainAmplitude = 50.0;
+
+    //! Weight of each finer noise octave relative to the previous one, in
+    //! [0, 1]. Zero gives smooth hills, one gives rugged terrain.
+    double terrainRoughness = 0.5;
+};
+
+//!
+//! Generates tile data and heightmaps without network access, to measure the
+//! pipeline on arbitrary tile ranges.
+//!
+//! Buildings are laid out on a jittered grid of city blocks, roads run along
+//! the block boundaries. The terrain is fractal value noise over global tile
+//! coordinates, so heightmaps of adjacent tiles share their edges. Output is
+//! deterministic for a given seed and tile.
+//!
+class CityGenerator
+{
+ public:
+    explicit CityGenerator(CityGeneratorConfig config);
+
+    std::unique_ptr<HeightData> GenerateHeightData(const Tile& tile,
+                                                   double extrusionScale) const;
+
+    std::unique_ptr<TileData> GenerateTileData(const Tile& tile) const;
+
+ private:
+    double GetElevation(double x, double y) const;
+    double GetNoise(double x, double y, unsigned int octave) const;
+
+    void AddBuildings(TileData& data, const Tile& tile) const;
+    void AddRoads(TileData& data, const Tile& tile) const;
+
+    unsigned int GetTileSeed(const Tile& tile, unsigned int salt) const;
+
+    CityGeneratorConfig m_config;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_CITY_GENERATOR_HPP
\ No newline at end of file
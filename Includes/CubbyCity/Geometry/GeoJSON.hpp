@@ -19,14 +19,14 @@ class GeoJSON
  public:
     static bool ExtractPoint(const nlohmann::json::value_type& in, Point& out,
                              const Tile& tile, Point* last = nullptr);
-    static void ExtractLine(const nlohmann::json::value_type& in, Line& out,
-                            const Tile& tile);
+    static void ExtractLine(const nlohmann::json::value_type& in,
+                            TileData& data, const Tile& tile);
     static void ExtractPolygon(const nlohmann::json::value_type& in,
-                               Polygon& out, const Tile& tile);
+                               TileData& data, const Tile& tile);
     static void ExtractFeature(const nlohmann::json::value_type& in,
-                               Feature& out, const Tile& tile);
+                               Feature& out, TileData& data, const Tile& tile);
     static void ExtractLayer(const nlohmann::json::value_type& in, Layer& out,
-                             const Tile& tile);
+                             TileData& data, const Tile& tile);
 };
 }  // namespace CubbyCity
 
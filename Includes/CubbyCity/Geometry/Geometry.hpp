@@ -7,12 +7,23 @@
 #ifndef CUBBYCITY_GEOMETRY_HPP
 #define CUBBYCITY_GEOMETRY_HPP
 
+#include <CubbyCity/Geometry/CityGenerator.hpp>
 #include <CubbyCity/Geometry/GeometryData.hpp>
+#include <CubbyCity/Geometry/MeshCache.hpp>
 #include <CubbyCity/Geometry/Tile.hpp>
+#include <CubbyCity/Geometry/TileCache.hpp>
+#include <CubbyCity/Geometry/TileJournal.hpp>
+#include <CubbyCity/Platform/IDownloader.hpp>
+#include <CubbyCity/Programs/Profiler.hpp>
 #include <CubbyCity/Programs/ProgramConfig.hpp>
 
+#include <json/json.hpp>
+
+#include <array>
 #include <memory>
+#include <ostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace CubbyCity
@@ -21,19 +32,103 @@ class Geometry
 {
  public:
     Geometry() = default;
-    explicit Geometry(ProgramConfig config);
+    //! Tiles are fetched through \p downloader, or a downloader made from
+    //! the configured tile source when it is null. Decoded tiles are looked
+    //! up in and added to \p tileCache when given. When a mesh cache
+    //! directory is configured or the build is incremental, tiles whose
+    //! meshes are found in the cache are neither fetched nor built.
+    explicit Geometry(ProgramConfig config,
+                      std::shared_ptr<IDownloader> downloader = nullptr,
+                      std::shared_ptr<TileCache> tileCache = nullptr);
 
     void ParseTiles(const std::string& tileX, const std::string& tileY,
                     int tileZ);
 
+    //! Selects \p tiles at \p tileZ, in any shape. The borders of a tile are
+    //! its sides without a neighbor in the selection, so that the pedestal
+    //! and the terrain stitching follow the outline of the region.
+    void ParseTiles(const std::vector<glm::ivec2>& tiles, int tileZ);
+
+    //! Fetches the tiles that are not cached yet. A tile is tried again
+    //! up to the configured number of retries; when it still fails, the run
+    //! throws, or leaves the tile out when failed tiles are skipped.
     void DownloadData(const std::string& apiKey, bool terrain,
                       double terrainExtrusionScale, bool buildings, bool roads);
 
+    void GenerateData(const CityGenerator& generator, bool terrain,
+                      double terrainExtrusionScale, bool buildings, bool roads);
+
     void AdjustTerrainEdges();
 
     void BuildMeshes();
 
+    void ExportToFile();
+    void ExportToStream(std::ostream& file);
+
+    Profiler& GetProfiler();
+    const Profiler& GetProfiler() const;
+
+    // Mesh building kernels. They do not depend on the geometry state, so
+    // they can be measured on their own.
+    static void BuildPlane(PolygonMesh& outMesh, int width, int height, int nw,
+                           int nh, bool flip = false);
+
+    static void BuildPedestalPlanes(
+        const Tile& tile, PolygonMesh& outMesh,
+        const std::unique_ptr<HeightData>& elevation, int subDiv,
+        double pedestalHeight);
+
+    static double BuildPolygonExtrusion(
+        const PolygonView& polygon, double minHeight, double height,
+        PolygonMesh& outMesh, const std::unique_ptr<HeightData>& elevation,
+        double inverseTileScale);
+
+    static void BuildPolygon(const PolygonView& polygon, double height,
+                             PolygonMesh& outMesh, double centroidHeight,
+                             double inverseTileScale);
+
+    static void BuildRoads(const TileData& data, const Range& lines,
+                           PolygonMesh& outMesh,
+                           const std::unique_ptr<HeightData>& elevation,
+                           double extrusionWidth, double height,
+                           double inverseTileScale);
+
  private:
+    //! The meshes of a tile are cached in parts, so that changing an option
+    //! only rebuilds the part that depends on it.
+    enum MeshPart
+    {
+        Terrain,
+        Features
+    };
+
+    void FetchTile(const Tile& tile, const std::string& apiKey, bool terrain,
+                   double terrainExtrusionScale, bool tileData);
+
+    void LoadCachedMeshes();
+    bool UseCachedMeshes(const Tile& tile, MeshPart part,
+                         const glm::dvec2& offset);
+    void StoreMeshes(const Tile& tile, MeshPart part, size_t firstMesh);
+
+    bool IsCached(const Tile& tile, MeshPart part) const;
+    bool IsBuilt(const Tile& tile) const;
+    bool IsTerrainNeeded(const Tile& tile) const;
+
+    std::vector<MeshPart> GetMeshParts() const;
+    std::string GetMeshCacheKey(const Tile& tile, MeshPart part,
+                                const nlohmann::json& options) const;
+    std::string GetSourceVersion(const std::string& url) const;
+    std::vector<Tile> GetNeighbors(const Tile& tile) const;
+
+    bool IsCheckpointed() const;
+    void OpenJournal();
+
+    std::string GetOutputName() const;
+    void UpdateManifest(const std::string& outFile) const;
+
+    static const std::vector<std::string>& GetPartOptions(MeshPart part);
+    static const char* GetPartName(MeshPart part);
+
     void BuildTerrainMesh(const Tile& tile, const glm::dvec2& offset,
                           const std::unique_ptr<HeightData>& texData);
 
@@ -43,37 +138,15 @@ class Geometry
     void BuildVectorTileMesh(const Tile& tile, const glm::dvec2& offset,
                              const std::unique_ptr<HeightData>& texData);
 
-    void BuildBuildings(const std::vector<Polygon>& polygons,
+    void AddVectorTileMesh(std::unique_ptr<PolygonMesh> mesh, const Tile& tile,
+                           const glm::dvec2& offset);
+
+    void BuildBuildings(const TileData& data, const Range& polygons,
                         std::unique_ptr<PolygonMesh>& mesh, const Tile& tile,
                         const std::unique_ptr<HeightData>& texData,
                         double minHeight, double height);
 
-    void BuildingRoads(const std::vector<Line>& lines,
-                       std::unique_ptr<PolygonMesh>& mesh, const Tile& tile,
-                       const std::unique_ptr<HeightData>& texData) const;
-
-    void ExportToFile();
-
-    static void BuildPlane(std::vector<PolygonVertex>& outVertices,
-                           std::vector<unsigned int>& outIndices, int width,
-                           int height, int nw, int nh, bool flip = false);
-
-    static void BuildPedestalPlanes(
-        const Tile& tile, std::vector<PolygonVertex>& outVertices,
-        std::vector<unsigned int>& outIndices,
-        const std::unique_ptr<HeightData>& elevation, int subDiv,
-        double pedestalHeight);
-
-    static double BuildPolygonExtrusion(
-        const Polygon& polygon, double minHeight, double height,
-        std::vector<PolygonVertex>& outVertices,
-        std::vector<unsigned int>& outIndices,
-        const std::unique_ptr<HeightData>& elevation, double inverseTileScale);
-
-    static void BuildPolygon(const Polygon& polygon, double height,
-                             std::vector<PolygonVertex>& outVertices,
-                             std::vector<unsigned int>& outIndices,
-                             double centroidHeight, double inverseTileScale);
+    void SimplifyMesh(PolygonMesh& mesh, const Tile& tile) const;
 
     static void AddPolygonPolylinePoint(Line& line, glm::dvec3 cur,
                                         glm::dvec3 next, glm::dvec3 last,
@@ -83,9 +156,20 @@ class Geometry
     std::vector<Tile> m_tiles;
     std::vector<std::unique_ptr<PolygonMesh>> m_meshes;
     std::unordered_map<Tile, std::unique_ptr<HeightData>> m_heightData;
-    std::unordered_map<Tile, std::unique_ptr<TileData>> m_vectorTileData;
+    std::unordered_map<Tile, std::shared_ptr<const TileData>> m_vectorTileData;
 
     ProgramConfig m_config;
+    Profiler m_profiler;
+    std::shared_ptr<IDownloader> m_downloader;
+    std::shared_ptr<TileCache> m_tileCache;
+
+    std::unique_ptr<MeshCache> m_meshCache;
+    std::unordered_map<Tile, std::array<std::string, 2>> m_meshCacheKeys;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<PolygonMesh>>>
+        m_cachedMeshes;
+
+    std::unique_ptr<TileJournal> m_journal;
+    std::unordered_set<Tile> m_failedTiles;
 };
 }  // namespace CubbyCity
 
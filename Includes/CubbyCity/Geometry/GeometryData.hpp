@@ -16,9 +16,14 @@
 
 namespace CubbyCity
 {
+#if defined(CUBBYCITY_MESH_FLOAT32)
+using MeshVector = glm::vec3;
+#else
+using MeshVector = glm::dvec3;
+#endif
+
 using Point = glm::dvec3;
 using Line = std::vector<Point>;
-using Polygon = std::vector<Line>;
 
 enum class GeometryType
 {
@@ -28,18 +33,145 @@ enum class GeometryType
     Polygons
 };
 
+//! Offset and length of a run of elements stored in a TileData buffer.
+struct Range
+{
+    size_t offset = 0;
+    size_t count = 0;
+};
+
+//! Read-only view of a line or a polygon ring.
+class LineView
+{
+ public:
+    using value_type = Point;
+
+    LineView(const Point* data, size_t size) : m_data(data), m_size(size)
+    {
+        // Do nothing
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    const Point& operator[](size_t i) const
+    {
+        return m_data[i];
+    }
+
+    const Point& back() const
+    {
+        return m_data[m_size - 1];
+    }
+
+    const Point* begin() const
+    {
+        return m_data;
+    }
+
+    const Point* end() const
+    {
+        return m_data + m_size;
+    }
+
+ private:
+    const Point* m_data;
+    size_t m_size;
+};
+
+//! Read-only view of a polygon, the first ring is the outer ring.
+class PolygonView
+{
+ public:
+    using value_type = LineView;
+
+    class Iterator
+    {
+     public:
+        Iterator(const PolygonView& polygon, size_t index)
+            : m_polygon(polygon), m_index(index)
+        {
+            // Do nothing
+        }
+
+        LineView operator*() const
+        {
+            return m_polygon[m_index];
+        }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return m_index != rhs.m_index;
+        }
+
+     private:
+        const PolygonView& m_polygon;
+        size_t m_index;
+    };
+
+    PolygonView(const Point* points, const Range* rings, size_t size)
+        : m_points(points), m_rings(rings), m_size(size)
+    {
+        // Do nothing
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    LineView operator[](size_t i) const
+    {
+        return LineView(m_points + m_rings[i].offset, m_rings[i].count);
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(*this, 0);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(*this, m_size);
+    }
+
+ private:
+    const Point* m_points;
+    const Range* m_rings;
+    size_t m_size;
+};
+
 struct Properties
 {
     std::map<std::string, double> numericProps;
 };
 
+//! Geometry of a feature is stored as ranges into its TileData buffers.
 struct Feature
 {
     GeometryType geometryType = GeometryType::Polygons;
 
-    std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+    Range points;
+    Range lines;
+    Range polygons;
 
     Properties props;
 };
@@ -55,8 +187,26 @@ struct Layer
     std::vector<Feature> features;
 };
 
+//! Per-tile arena: every coordinate of the tile is packed into one buffer,
+//! lines and polygons refer to it by range, so the whole tile is released at
+//! once.
 struct TileData
 {
+    LineView GetLine(size_t i) const
+    {
+        return LineView(points.data() + lines[i].offset, lines[i].count);
+    }
+
+    PolygonView GetPolygon(size_t i) const
+    {
+        return PolygonView(points.data(), lines.data() + polygons[i].offset,
+                           polygons[i].count);
+    }
+
+    std::vector<Point> points;
+    std::vector<Range> lines;
+    std::vector<Range> polygons;
+
     std::vector<Layer> layers;
 };
 
@@ -67,17 +217,53 @@ struct HeightData
     std::vector<std::vector<double>> elevation;
 };
 
-struct PolygonVertex
+enum class NormalWeighting
 {
-    glm::dvec3 position;
-    glm::dvec3 normal;
+    Uniform,
+    Area,
+    Angle
 };
 
+//! Mesh with separate position and normal arrays. Normals are only stored
+//! when the mesh is created with them; attributes are single precision when
+//! CUBBYCITY_MESH_FLOAT32 is defined. Batched meshes may carry the index of
+//! the source feature within its layer for every vertex, along with the
+//! tile and layer that index refers to.
 struct PolygonMesh
 {
+    explicit PolygonMesh(bool _hasNormals = false) : hasNormals(_hasNormals)
+    {
+        // Do nothing
+    }
+
+    void Reserve(size_t numVertices)
+    {
+        positions.reserve(numVertices);
+        if (hasNormals)
+        {
+            normals.reserve(numVertices);
+        }
+    }
+
+    void AddVertex(const glm::dvec3& position, const glm::dvec3& normal)
+    {
+        positions.emplace_back(position);
+        if (hasNormals)
+        {
+            normals.emplace_back(normal);
+        }
+    }
+
     std::vector<unsigned int> indices;
-    std::vector<PolygonVertex> vertices;
+    std::vector<MeshVector> positions;
+    std::vector<MeshVector> normals;
+    std::vector<unsigned int> featureIds;
+
+    //! Tile and layer of the feature ids, as "z_x_y_layer".
+    std::string featureGroup;
+
     glm::dvec2 offset;
+    bool hasNormals;
 };
 }  // namespace CubbyCity
 
@@ -8,12 +8,20 @@
 #define CUBBYCITY_GEOMETRY_UTILS_HPP
 
 #include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Commons/FastMath.hpp>
+#include <CubbyCity/Commons/Parallel.hpp>
+#include <CubbyCity/Geometry/GeometryData.hpp>
 #include <CubbyCity/Geometry/TileUtils.hpp>
+#include <CubbyCity/Programs/Profiler.hpp>
 
 #include <glm/glm.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <vector>
 
 namespace CubbyCity
 {
@@ -27,6 +35,42 @@ inline glm::dvec2 ConvertLonLatToMeters(const glm::dvec2 lonLat)
     return meters;
 }
 
+inline glm::dvec2 ConvertMetersToLonLat(const glm::dvec2 meters)
+{
+    glm::dvec2 lonLat;
+    lonLat.x = meters.x * 180.0 / HALF_CIRCUMFERENCE;
+    lonLat.y = (2.0 * atan(exp(meters.y / RADIUS_EARTH)) - MATH_PI * 0.5) *
+               180.0 / MATH_PI;
+
+    return lonLat;
+}
+
+//! Projects \p count lon/lat pairs in place into tile space, given the tile
+//! origin in meters and the inverse tile scale. On input \p x holds longitudes
+//! and \p y latitudes in degrees. Latitudes are clamped to the Web Mercator
+//! limit.
+inline void ConvertLonLatToTile(double* x, double* y, size_t count,
+                                const glm::dvec2& tileOrigin, double invScale)
+{
+    const double scaleX = HALF_CIRCUMFERENCE * INV_180 * invScale;
+    const double scaleY = 0.5 * RADIUS_EARTH * invScale;
+    const double offsetX = tileOrigin.x * invScale;
+    const double offsetY = tileOrigin.y * invScale;
+    const double toRadians = MATH_PI * INV_180;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double lat = std::min(std::max(y[i], -MAX_MERCATOR_LATITUDE),
+                                    MAX_MERCATOR_LATITUDE);
+
+        // ln(tan(pi / 4 + lat / 2)) == 0.5 * ln((1 + sin) / (1 - sin))
+        const double s = FastSin(lat * toRadians);
+
+        x[i] = x[i] * scaleX - offsetX;
+        y[i] = FastLog((1.0 + s) / (1.0 - s)) * scaleY - offsetY;
+    }
+}
+
 inline glm::dvec2 ConvertPixelToMeters(const glm::dvec2 pixel, const int zoom,
                                        double invTileSize)
 {
@@ -94,40 +138,221 @@ inline double SampleElevation(glm::dvec2 position,
     return bilinearHeight;
 }
 
-inline void ComputeNormals(PolygonMesh& mesh)
+//! Gives every vertex shared by faces meeting at more than \p angle radians
+//! its own copy per group of faces, so that ComputeNormals keeps the edge
+//! hard instead of smoothing it, e.g. between the walls and the roof of a
+//! building welded by the simplifier.
+inline void SplitSharpEdges(PolygonMesh& mesh,
+                            double angle = SHARP_EDGE_ANGLE)
 {
-    for (size_t i = 0; i < mesh.indices.size(); i += 3)
+    auto& positions = mesh.positions;
+    auto& indices = mesh.indices;
+    const size_t numVertices = positions.size();
+    const size_t numCorners = indices.size() - indices.size() % 3;
+    const double minDot = std::cos(angle);
+
+    std::vector<glm::dvec3> faceNormals(numCorners / 3);
+    for (size_t t = 0; t < faceNormals.size(); ++t)
     {
-        const int i1 = mesh.indices[i + 0];
-        const int i2 = mesh.indices[i + 1];
-        const int i3 = mesh.indices[i + 2];
+        const glm::dvec3 v1(positions[indices[t * 3 + 0]]);
+        const glm::dvec3 v2(positions[indices[t * 3 + 1]]);
+        const glm::dvec3 v3(positions[indices[t * 3 + 2]]);
 
-        const glm::dvec3& v1 = mesh.vertices[i1].position;
-        const glm::dvec3& v2 = mesh.vertices[i2].position;
-        const glm::dvec3& v3 = mesh.vertices[i3].position;
+        const glm::dvec3 n = glm::cross(v2 - v1, v3 - v1);
+        const double length = glm::length(n);
 
-        const glm::dvec3 d = glm::normalize(glm::cross(v2 - v1, v3 - v1));
+        if (length > std::numeric_limits<double>::epsilon())
+        {
+            faceNormals[t] = n / length;
+        }
+    }
 
-        mesh.vertices[i1].normal += d;
-        mesh.vertices[i2].normal += d;
-        mesh.vertices[i3].normal += d;
+    std::vector<size_t> offsets(numVertices + 1, 0);
+    for (size_t i = 0; i < numCorners; ++i)
+    {
+        ++offsets[indices[i] + 1];
     }
 
-    for (auto& v : mesh.vertices)
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<size_t> corners(numCorners);
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < numCorners; ++i)
     {
-        v.normal = glm::normalize(v.normal);
+        corners[cursor[indices[i]]++] = i;
     }
+
+    const bool copyNormals = mesh.normals.size() == numVertices;
+    const bool copyFeatureIds = mesh.featureIds.size() == numVertices;
+
+    // Group the faces around each vertex by the normal of the first face of
+    // the group; the first group keeps the vertex, the others get copies
+    std::vector<std::pair<glm::dvec3, unsigned int>> groups;
+
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        groups.clear();
+
+        for (size_t k = offsets[v]; k < offsets[v + 1]; ++k)
+        {
+            const size_t corner = corners[k];
+            const glm::dvec3& normal = faceNormals[corner / 3];
+
+            // Degenerate faces join any group
+            auto group = std::find_if(
+                groups.begin(), groups.end(), [&](const auto& g) {
+                    return g.first == glm::dvec3(0.0) ||
+                           normal == glm::dvec3(0.0) ||
+                           glm::dot(g.first, normal) >= minDot;
+                });
+
+            if (group == groups.end())
+            {
+                auto index = static_cast<unsigned int>(v);
+
+                if (!groups.empty())
+                {
+                    const MeshVector position = positions[v];
+                    index = static_cast<unsigned int>(positions.size());
+                    positions.push_back(position);
+
+                    if (copyNormals)
+                    {
+                        const MeshVector vertexNormal = mesh.normals[v];
+                        mesh.normals.push_back(vertexNormal);
+                    }
+                    if (copyFeatureIds)
+                    {
+                        const unsigned int featureId = mesh.featureIds[v];
+                        mesh.featureIds.push_back(featureId);
+                    }
+                }
+
+                groups.emplace_back(normal, index);
+                group = groups.end() - 1;
+            }
+            else if (group->first == glm::dvec3(0.0))
+            {
+                group->first = normal;
+            }
+
+            indices[corner] = group->second;
+        }
+    }
+}
+
+//! Traces its parallel chunks to \p profiler when given.
+inline void ComputeNormals(
+    PolygonMesh& mesh, NormalWeighting weighting = NormalWeighting::Uniform,
+    Profiler* profiler = nullptr)
+{
+    const auto& positions = mesh.positions;
+    const auto& indices = mesh.indices;
+    const size_t numVertices = positions.size();
+    const size_t numCorners = indices.size() - indices.size() % 3;
+
+    mesh.hasNormals = true;
+    mesh.normals.resize(numVertices, MeshVector(0.0));
+
+    // Face normals, scaled by twice the triangle area when area weighted
+    std::vector<glm::dvec3> faceNormals(numCorners / 3);
+
+    ParallelRangeFor(
+        0, faceNormals.size(),
+        [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t)
+            {
+                const glm::dvec3 v1(positions[indices[t * 3 + 0]]);
+                const glm::dvec3 v2(positions[indices[t * 3 + 1]]);
+                const glm::dvec3 v3(positions[indices[t * 3 + 2]]);
+
+                glm::dvec3 n = glm::cross(v2 - v1, v3 - v1);
+                const double length = glm::length(n);
+
+                if (length < std::numeric_limits<double>::epsilon())
+                {
+                    n = glm::dvec3(0.0);
+                }
+                else if (weighting != NormalWeighting::Area)
+                {
+                    n /= length;
+                }
+
+                faceNormals[t] = n;
+            }
+        },
+        DEFAULT_GRAIN_SIZE, profiler, "faceNormals");
+
+    // Build vertex to triangle corner adjacency, so that every vertex gathers
+    // its own normal without write conflicts between threads
+    std::vector<size_t> offsets(numVertices + 1, 0);
+    for (size_t i = 0; i < numCorners; ++i)
+    {
+        ++offsets[indices[i] + 1];
+    }
+
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<size_t> corners(numCorners);
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < numCorners; ++i)
+    {
+        corners[cursor[indices[i]]++] = i;
+    }
+
+    ParallelRangeFor(
+        0, numVertices,
+        [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v)
+            {
+                glm::dvec3 sum(0.0);
+
+                for (size_t k = offsets[v]; k < offsets[v + 1]; ++k)
+                {
+                    const size_t corner = corners[k];
+                    const size_t t = corner / 3;
+                    double weight = 1.0;
+
+                    if (weighting == NormalWeighting::Angle)
+                    {
+                        const glm::dvec3 p(positions[v]);
+                        const glm::dvec3 a(
+                            positions[indices[t * 3 + (corner + 1) % 3]]);
+                        const glm::dvec3 b(
+                            positions[indices[t * 3 + (corner + 2) % 3]]);
+                        const double la = glm::length(a - p);
+                        const double lb = glm::length(b - p);
+
+                        weight = 0.0;
+                        if (la > 0.0 && lb > 0.0)
+                        {
+                            const double cosAngle =
+                                glm::dot(a - p, b - p) / (la * lb);
+                            weight = std::acos(glm::clamp(cosAngle, -1.0, 1.0));
+                        }
+                    }
+
+                    sum += faceNormals[t] * weight;
+                }
+
+                // Vertices of degenerate faces only, or of none, point up
+                // rather than keep a normal from before a simplification
+                const double length = glm::length(sum);
+                mesh.normals[v] = length > 0.0 ? MeshVector(sum / length)
+                                               : MeshVector(0.0, 0.0, 1.0);
+            }
+        },
+        DEFAULT_GRAIN_SIZE, profiler, "vertexNormals");
 }
 
-inline glm::dvec2 GetCentroid(
-    const std::vector<std::vector<glm::dvec3>>& polygon)
+inline glm::dvec2 GetCentroid(const PolygonView& polygon)
 {
     glm::dvec2 centroid{};
     int n = 0;
 
-    for (auto& line : polygon)
+    for (const auto& line : polygon)
     {
-        for (auto& point : line)
+        for (const auto& point : line)
         {
             centroid.x += point.x;
             centroid.y += point.y;
@@ -144,6 +369,219 @@ inline glm::dvec2 GetCentroid(
     return centroid;
 }
 
+//! Returns the westmost vertex of the outer rings of \p polygons, the
+//! southmost of them on a tie, or the origin when there is none. Each tile
+//! clips its copy of a feature to its own buffer, which only takes away
+//! vertices and adds new ones on the buffer sides, so every tile whose
+//! buffer holds this vertex of a convex footprint finds the same one,
+//! unlike a centroid of the copy.
+inline glm::dvec2 GetAnchor(const TileData& data, const Range& polygons)
+{
+    glm::dvec2 anchor{};
+    bool found = false;
+
+    for (size_t i = 0; i < polygons.count; ++i)
+    {
+        const PolygonView polygon = data.GetPolygon(polygons.offset + i);
+        if (polygon.size() == 0)
+        {
+            continue;
+        }
+
+        for (const auto& point : polygon[0])
+        {
+            if (!found || point.x < anchor.x ||
+                (point.x == anchor.x && point.y < anchor.y))
+            {
+                anchor = glm::dvec2(point.x, point.y);
+                found = true;
+            }
+        }
+    }
+
+    return anchor;
+}
+
+//! Clips the closed \p ring to the tile square [-1, 1] x [-1, 1] one side
+//! at a time (Sutherland-Hodgman) and writes the closed result to \p out,
+//! left empty when nothing remains.
+inline void ClipRingToTile(const LineView& ring, Line& out, Line& scratch)
+{
+    out.assign(ring.begin(), ring.end());
+    if (out.size() > 1 && out.front() == out.back())
+    {
+        out.pop_back();
+    }
+
+    for (int side = 0; side < 4 && !out.empty(); ++side)
+    {
+        const int axis = side / 2;
+        const double limit = side % 2 == 0 ? -1.0 : 1.0;
+        const auto inside = [&](const Point& p) {
+            return limit < 0.0 ? p[axis] >= limit : p[axis] <= limit;
+        };
+
+        scratch.swap(out);
+        out.clear();
+
+        for (size_t i = 0, j = scratch.size() - 1; i < scratch.size(); j = i++)
+        {
+            const Point& prev = scratch[j];
+            const Point& cur = scratch[i];
+
+            if (inside(cur) != inside(prev))
+            {
+                const Point d = cur - prev;
+                Point cut = prev + d * ((limit - prev[axis]) / d[axis]);
+                cut[axis] = limit;
+                out.push_back(cut);
+            }
+
+            if (inside(cur))
+            {
+                out.push_back(cur);
+            }
+        }
+    }
+
+    if (out.size() < 3)
+    {
+        out.clear();
+        return;
+    }
+
+    out.push_back(out.front());
+}
+
+//! Appends to \p out the polygons of \p polygons clipped to the tile square
+//! and returns their range. A polygon whose outer ring is clipped away is
+//! dropped, so are holes outside the square.
+inline Range ClipPolygonsToTile(const TileData& data, const Range& polygons,
+                                TileData& out)
+{
+    Line ring;
+    Line scratch;
+    const size_t firstPolygon = out.polygons.size();
+
+    for (size_t i = 0; i < polygons.count; ++i)
+    {
+        const PolygonView polygon = data.GetPolygon(polygons.offset + i);
+        const size_t firstPoint = out.points.size();
+        const size_t firstLine = out.lines.size();
+
+        for (size_t j = 0; j < polygon.size(); ++j)
+        {
+            ClipRingToTile(polygon[j], ring, scratch);
+
+            if (ring.empty())
+            {
+                if (j == 0)
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            out.lines.push_back({ out.points.size(), ring.size() });
+            out.points.insert(out.points.end(), ring.begin(), ring.end());
+        }
+
+        if (out.lines.size() == firstLine)
+        {
+            out.points.resize(firstPoint);
+            continue;
+        }
+
+        out.polygons.push_back({ firstLine, out.lines.size() - firstLine });
+    }
+
+    return { firstPolygon, out.polygons.size() - firstPolygon };
+}
+
+//! Appends to \p out the parts of \p lines within the tile square and
+//! returns their range. Each segment is clipped on its own (Liang-Barsky),
+//! and a line that leaves the square and comes back is split in two.
+inline Range ClipLinesToTile(const TileData& data, const Range& lines,
+                             TileData& out)
+{
+    const size_t firstLine = out.lines.size();
+
+    for (size_t i = 0; i < lines.count; ++i)
+    {
+        const LineView line = data.GetLine(lines.offset + i);
+        size_t start = out.points.size();
+
+        const auto finish = [&] {
+            const size_t count = out.points.size() - start;
+            if (count >= 2)
+            {
+                out.lines.push_back({ start, count });
+            }
+            else
+            {
+                out.points.resize(start);
+            }
+            start = out.points.size();
+        };
+
+        for (size_t j = 0; j + 1 < line.size(); ++j)
+        {
+            const Point& a = line[j];
+            const Point d = line[j + 1] - a;
+            double t0 = 0.0;
+            double t1 = 1.0;
+
+            // Distances to the four sides along the segment
+            const double p[4] = { -d.x, d.x, -d.y, d.y };
+            const double q[4] = { a.x + 1.0, 1.0 - a.x, a.y + 1.0, 1.0 - a.y };
+
+            for (int k = 0; k < 4 && t0 < t1; ++k)
+            {
+                if (p[k] == 0.0)
+                {
+                    t1 = q[k] < 0.0 ? -1.0 : t1;
+                }
+                else if (p[k] < 0.0)
+                {
+                    t0 = std::max(t0, q[k] / p[k]);
+                }
+                else
+                {
+                    t1 = std::min(t1, q[k] / p[k]);
+                }
+            }
+
+            // Drop what is outside, and the slivers of lines that stop on a
+            // side of the square
+            const bool cut = t0 > 0.0 || t1 < 1.0;
+            if (t0 >= t1 || (cut && glm::length(d) * (t1 - t0) < EPSILON))
+            {
+                finish();
+                continue;
+            }
+
+            // The segment goes on from the last point unless it was cut
+            if (t0 > 0.0 || out.points.size() == start)
+            {
+                finish();
+                out.points.push_back(a + d * t0);
+            }
+
+            out.points.push_back(a + d * t1);
+
+            if (t1 < 1.0)
+            {
+                finish();
+            }
+        }
+
+        finish();
+    }
+
+    return { firstLine, out.lines.size() - firstLine };
+}
+
 inline glm::dvec3 GetPerp(const glm::dvec3& v)
 {
     return glm::normalize(glm::dvec3(-v.y, v.x, 0.0));
@@ -0,0 +1,54 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_MESH_CACHE_HPP
+#define CUBBYCITY_MESH_CACHE_HPP
+
+#include <CubbyCity/Geometry/GeometryData.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CubbyCity
+{
+//!
+//! Content-addressed store of built tile meshes on disk. A key describes
+//! everything a tile's meshes depend on; it is hashed into the file name and
+//! kept in the file, so a hash collision reads as a miss. Meshes are written
+//! as raw arrays in the byte order and precision of the build, and files of
+//! another precision are ignored.
+//!
+class MeshCache
+{
+ public:
+    explicit MeshCache(std::string directory);
+
+    //! Appends the meshes stored under \p key to \p meshes. Returns false and
+    //! leaves \p meshes unchanged when there is no readable entry.
+    bool Load(const std::string& key,
+              std::vector<std::unique_ptr<PolygonMesh>>& meshes) const;
+
+    //! Stores meshes [begin, end) of \p meshes under \p key. The file is
+    //! written aside and renamed, so readers never see a partial entry.
+    void Store(const std::string& key,
+               const std::vector<std::unique_ptr<PolygonMesh>>& meshes,
+               size_t begin, size_t end) const;
+
+    //! Removes the entry \p entryName, as returned by GetEntryName.
+    void Remove(const std::string& entryName) const;
+
+    std::string GetFilePath(const std::string& key) const;
+
+    //! Returns the path of the entry of \p key within the cache directory.
+    static std::string GetEntryName(const std::string& key);
+
+ private:
+    std::string m_directory;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_MESH_CACHE_HPP
\ No newline at end of file
@@ -0,0 +1,88 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_MESH_SIMPLIFIER_HPP
+#define CUBBYCITY_MESH_SIMPLIFIER_HPP
+
+#include <CubbyCity/Geometry/GeometryData.hpp>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <vector>
+
+namespace CubbyCity
+{
+//!
+//! Quadric error metric edge collapse decimation (Garland and Heckbert).
+//!
+//! Vertices are welded by position and feature id before decimation, so
+//! touching features are never merged, and normals are dropped, so they have
+//! to be recomputed afterwards. Vertices lying on the tile border (x or y
+//! equal to -1 or 1 in tile space) are never moved nor removed, so adjacent
+//! tiles keep lining up after decimation.
+//!
+class MeshSimplifier
+{
+ public:
+    explicit MeshSimplifier(PolygonMesh& mesh);
+
+    //! Collapses edges until the triangle count reaches \p targetRatio of the
+    //! original count or the next collapse would exceed \p maxError (squared
+    //! distance in mesh units). A non-positive \p maxError disables the bound.
+    void Simplify(double targetRatio, double maxError);
+
+ private:
+    struct Quadric
+    {
+        Quadric& operator+=(const Quadric& rhs);
+
+        void AddPlane(const glm::dvec3& n, double d, double weight);
+        double Evaluate(const glm::dvec3& v) const;
+        bool Optimize(glm::dvec3& out) const;
+
+        std::array<double, 10> m{};
+    };
+
+    struct Collapse
+    {
+        bool operator<(const Collapse& rhs) const;
+
+        double cost;
+        unsigned int keep;
+        unsigned int remove;
+        unsigned int keepStamp;
+        unsigned int removeStamp;
+        glm::dvec3 target;
+    };
+
+    void Weld();
+    void ComputeQuadrics();
+    void PushCollapse(unsigned int v0, unsigned int v1);
+    bool Flips(unsigned int moved, unsigned int other,
+               const glm::dvec3& target) const;
+    void ApplyCollapse(const Collapse& collapse);
+    void WriteBack();
+
+    PolygonMesh& m_mesh;
+
+    std::vector<glm::dvec3> m_positions;
+    std::vector<unsigned int> m_featureIds;
+    std::vector<Quadric> m_quadrics;
+    std::vector<unsigned int> m_stamps;
+    std::vector<bool> m_locked;
+    std::vector<bool> m_removedVertices;
+    std::vector<std::vector<unsigned int>> m_vertexTriangles;
+
+    std::vector<std::array<unsigned int, 3>> m_triangles;
+    std::vector<bool> m_removedTriangles;
+    size_t m_numTriangles = 0;
+
+    std::vector<Collapse> m_heap;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_MESH_SIMPLIFIER_HPP
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include <glm/glm.hpp>
 
 #include <bitset>
+#include <cmath>
+#include <string>
 
 namespace CubbyCity
 {
@@ -40,6 +42,39 @@ struct Tile
         return x == rhs.x && y == rhs.y && z == rhs.z;
     }
 
+    //! Returns the tile as "z/x/y", the usual slippy map notation.
+    std::string ToString() const
+    {
+        return std::to_string(z) + "/" + std::to_string(x) + "/" +
+               std::to_string(y);
+    }
+
+    //! Returns whether \p point, in tile space, belongs to the tile: it lies
+    //! in the half-open square [-1, 1) x [-1, 1), or past a side on the
+    //! border of the region, where no other tile would take it.
+    bool Owns(const glm::dvec2& point) const
+    {
+        return (point.x >= -1.0 || borders[Left]) &&
+               (point.x < 1.0 || borders[Right]) &&
+               (point.y >= -1.0 || borders[Bottom]) &&
+               (point.y < 1.0 || borders[Top]);
+    }
+
+    //! Returns whether the tile owns \p point, in tile space, like Owns but
+    //! on a grid of 1 / 2^GRID_BITS tile shared by all tiles of the zoom
+    //! level. The snapped position is an integer, so neighbors that project
+    //! the same point with slightly different rounding still agree on the
+    //! tile holding it, also when it lies on their common side.
+    bool OwnsOnGrid(const glm::dvec2& point) const
+    {
+        const long long column = SnapToGrid(x + 0.5 * (point.x + 1.0));
+        const long long row = SnapToGrid(y + 0.5 * (1.0 - point.y));
+
+        return (column >= x || borders[Left]) &&
+               (column <= x || borders[Right]) &&
+               (row >= y || borders[Top]) && (row <= y || borders[Bottom]);
+    }
+
     int x;
     int y;
     int z;
@@ -48,6 +83,18 @@ struct Tile
 
     double invScale = 0.0;
     glm::dvec2 tileOrigin = { 0.0, 0.0 };
+
+ private:
+    static constexpr int GRID_BITS = 20;
+
+    //! Returns the index of the tile holding \p position, given in tiles,
+    //! after snapping it to the grid.
+    static long long SnapToGrid(double position)
+    {
+        const double snapped =
+            std::ldexp(std::round(std::ldexp(position, GRID_BITS)), -GRID_BITS);
+        return static_cast<long long>(std::floor(snapped));
+    }
 };
 }  // namespace CubbyCity
 
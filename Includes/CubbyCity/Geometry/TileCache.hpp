@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_TILE_CACHE_HPP
+#define CUBBYCITY_TILE_CACHE_HPP
+
+#include <CubbyCity/Commons/LRUCache.hpp>
+#include <CubbyCity/Geometry/GeometryData.hpp>
+#include <CubbyCity/Geometry/Tile.hpp>
+
+#include <memory>
+#include <string>
+
+namespace CubbyCity
+{
+//!
+//! Memory-bounded caches of decoded heightmaps and parsed tile data, shared by
+//! the geometries of a long-running process. Heightmaps are handed out as
+//! copies since terrain stitching modifies them; tile data is only read and
+//! is shared.
+//!
+class TileCache
+{
+ public:
+    //! \p capacityBytes is split evenly between heightmaps and tile data.
+    explicit TileCache(size_t capacityBytes);
+
+    std::unique_ptr<HeightData> GetHeightData(const Tile& tile,
+                                              double extrusionScale);
+    void PutHeightData(const Tile& tile, double extrusionScale,
+                       const HeightData& data);
+
+    std::shared_ptr<const TileData> GetTileData(const Tile& tile);
+    void PutTileData(const Tile& tile, std::shared_ptr<const TileData> data);
+
+    size_t GetSize() const;
+
+ private:
+    LRUCache<std::string, std::shared_ptr<const HeightData>> m_heightData;
+    LRUCache<std::string, std::shared_ptr<const TileData>> m_tileData;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_TILE_CACHE_HPP
\ No newline at end of file
@@ -0,0 +1,61 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_TILE_COVER_HPP
+#define CUBBYCITY_TILE_COVER_HPP
+
+#include <CubbyCity/Programs/ProgramConfig.hpp>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+namespace CubbyCity
+{
+//!
+//! Area on the map given by polygons of lon/lat rings, in degrees. The first
+//! ring of a polygon is its outline and the others are its holes.
+//!
+struct Region
+{
+    using Ring = std::vector<glm::dvec2>;
+
+    std::vector<std::vector<Ring>> polygons;
+};
+
+//! Parses a bounding box "west,south,east,north" in degrees. Throws
+//! std::invalid_argument when it is malformed or empty.
+Region ParseBoundingBox(const std::string& bbox);
+
+//! Reads the Polygon and MultiPolygon geometries of a GeoJSON file, either
+//! bare or within features and collections. Throws std::invalid_argument
+//! when the file holds none.
+Region LoadRegion(const std::string& fileName);
+
+//! Returns the tiles at \p zoom whose interior the region overlaps, ordered
+//! by column then row. Tiles along an outline are found by walking its
+//! edges through the tile grid, and the tiles inside by filling each row
+//! between the crossings of the outline and the holes at the middle of the
+//! row. Latitudes are clamped to the Web Mercator limit. Throws
+//! std::invalid_argument as soon as more than \p maxTiles tiles are found.
+std::vector<glm::ivec2> CoverRegion(const Region& region, int zoom,
+                                    size_t maxTiles);
+
+//! Returns the tiles at \p zoom covering the tiles [startX, endX] x [startY,
+//! endY] at \p z, ordered by column then row. Throws std::invalid_argument
+//! when they are more than \p maxTiles.
+std::vector<glm::ivec2> CoverTileRange(int startX, int endX, int startY,
+                                       int endY, int z, int zoom,
+                                       size_t maxTiles);
+
+//! Returns the tiles at \p zoom selected by \p config: those of its region
+//! file, else of its bounding box, else of its tile range at tileZ, and no
+//! more than its maxTiles.
+std::vector<glm::ivec2> SelectTiles(const ProgramConfig& config, int zoom);
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_TILE_COVER_HPP
\ No newline at end of file
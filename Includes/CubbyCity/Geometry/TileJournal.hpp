@@ -0,0 +1,52 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_TILE_JOURNAL_HPP
+#define CUBBYCITY_TILE_JOURNAL_HPP
+
+#include <CubbyCity/Geometry/Tile.hpp>
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+namespace CubbyCity
+{
+//!
+//! Append-only log of the progress of a run, one "<state> z/x/y [detail]"
+//! line per event, flushed as it is written so that it survives a crash.
+//! The last state recorded for a tile wins when the journal is read back;
+//! a resumed run fetches the tiles last recorded as failed first.
+//!
+class TileJournal
+{
+ public:
+    enum class State
+    {
+        None,
+        Downloaded,
+        Built,
+        Failed
+    };
+
+    //! Opens \p fileName, reading the states it holds when \p resume is set
+    //! and starting a new journal otherwise.
+    TileJournal(const std::string& fileName, bool resume);
+
+    void Record(const Tile& tile, State state,
+                const std::string& detail = "");
+
+    State GetState(const Tile& tile) const;
+
+ private:
+    static const char* ToString(State state);
+
+    std::ofstream m_file;
+    std::unordered_map<std::string, State> m_states;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_TILE_JOURNAL_HPP
\ No newline at end of file
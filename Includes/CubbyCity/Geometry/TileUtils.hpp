@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <tuple>
+#include <stdexcept>
 #include <string>
 
 namespace CubbyCity
@@ -27,14 +28,14 @@ inline std::tuple<int, int> ExtractTileRange(const std::string& range)
 
     int start, end;
 
-    if (tilesRange.size() == 2)
+    try
     {
         start = std::stoi(tilesRange[0]);
-        end = std::stoi(tilesRange[1]);
+        end = tilesRange.size() == 2 ? std::stoi(tilesRange[1]) : start;
     }
-    else
+    catch (const std::out_of_range&)
     {
-        start = end = std::stoi(tilesRange[0]);
+        throw std::invalid_argument("Bad tile parameter");
     }
 
     if (end < start)
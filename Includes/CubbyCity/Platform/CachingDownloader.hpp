@@ -0,0 +1,42 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_CACHING_DOWNLOADER_HPP
+#define CUBBYCITY_CACHING_DOWNLOADER_HPP
+
+#include <CubbyCity/Commons/LRUCache.hpp>
+#include <CubbyCity/Platform/IDownloader.hpp>
+
+#include <memory>
+
+namespace CubbyCity
+{
+//!
+//! Keeps the payloads fetched through another downloader in memory, so that
+//! jobs sharing it do not fetch the same tile twice.
+//!
+class CachingDownloader : public IDownloader
+{
+ public:
+    CachingDownloader(std::shared_ptr<IDownloader> downloader,
+                      size_t capacityBytes);
+
+    bool DownloadData(std::string& out, const std::string& url) override;
+
+    //! Hands out the cached buffer itself, the bytes are not copied.
+    bool Download(Payload& out, const std::string& url) override;
+
+    std::string GetVersion(const std::string& url) override;
+
+    void Evict(const std::string& url) override;
+
+ private:
+    std::shared_ptr<IDownloader> m_downloader;
+    LRUCache<std::string, Payload> m_cache;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_CACHING_DOWNLOADER_HPP
\ No newline at end of file
@@ -9,15 +9,49 @@
 
 #include <CubbyCity/Platform/IDownloader.hpp>
 
+#include <mutex>
+#include <vector>
+
 namespace CubbyCity
 {
+//!
+//! Downloads with libcurl. Safe to use from several threads: each request
+//! borrows an easy handle from a pool of the instance, and the handles share
+//! the DNS, TLS session and connection caches, so a request reuses the
+//! connections that earlier ones kept alive whatever thread made them.
+//!
 class CurlDownloader : public IDownloader
 {
  public:
+    //! Timeouts are given in seconds, 0 waits forever.
+    explicit CurlDownloader(double timeout = 0.0, double connectTimeout = 0.0);
+
+    ~CurlDownloader() override;
+
+    CurlDownloader(const CurlDownloader&) = delete;
+    CurlDownloader& operator=(const CurlDownloader&) = delete;
+
     bool DownloadData(std::string& out, const std::string& url) override;
 
+    DownloadResult Fetch(std::string& out, const std::string& url) override;
+
  private:
     static size_t WriteData(void* ptr, size_t size, size_t nmemb, void* stream);
+    static size_t WriteHeader(char* buffer, size_t size, size_t nitems,
+                              void* userdata);
+
+    void* AcquireHandle();
+    void ReleaseHandle(void* handle);
+
+    double m_timeout;
+    double m_connectTimeout;
+
+    // curl handles, kept opaque so that users do not need the curl headers
+    void* m_share = nullptr;
+    std::mutex m_shareMutexes[8];
+
+    std::mutex m_handleMutex;
+    std::vector<void*> m_handles;
 };
 }  // namespace CubbyCity
 
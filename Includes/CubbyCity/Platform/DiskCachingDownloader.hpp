@@ -0,0 +1,42 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_DISK_CACHING_DOWNLOADER_HPP
+#define CUBBYCITY_DISK_CACHING_DOWNLOADER_HPP
+
+#include <CubbyCity/Platform/LocalDownloader.hpp>
+
+#include <memory>
+
+namespace CubbyCity
+{
+//!
+//! Keeps the payloads fetched through another downloader in a directory, in
+//! the layout read by LocalDownloader, so that they survive the process. A
+//! payload is written aside and renamed once complete, so an interrupted
+//! run never leaves a truncated tile behind.
+//!
+class DiskCachingDownloader : public IDownloader
+{
+ public:
+    DiskCachingDownloader(std::shared_ptr<IDownloader> downloader,
+                          std::string directory);
+
+    bool DownloadData(std::string& out, const std::string& url) override;
+
+    bool Download(Payload& out, const std::string& url) override;
+
+    std::string GetVersion(const std::string& url) override;
+
+    void Evict(const std::string& url) override;
+
+ private:
+    std::shared_ptr<IDownloader> m_downloader;
+    LocalDownloader m_local;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_DISK_CACHING_DOWNLOADER_HPP
\ No newline at end of file
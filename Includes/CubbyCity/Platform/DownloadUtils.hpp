@@ -7,8 +7,6 @@
 #ifndef CUBBYCITY_DOWNLOAD_UTILS_HPP
 #define CUBBYCITY_DOWNLOAD_UTILS_HPP
 
-#define STB_IMAGE_IMPLEMENTATION
-
 #include <CubbyCity/Commons/Macros.hpp>
 #include <CubbyCity/Geometry/GeoJSON.hpp>
 #include <CubbyCity/Geometry/Tile.hpp>
@@ -17,50 +15,97 @@
 #else
 #include <CubbyCity/Platform/CurlDownloader.hpp>
 #endif
+#include <CubbyCity/Platform/LocalDownloader.hpp>
+#include <CubbyCity/Platform/RetryingDownloader.hpp>
+#include <CubbyCity/Platform/TileURLs.hpp>
+#include <CubbyCity/Programs/Profiler.hpp>
+#include <CubbyCity/Programs/ProgramConfig.hpp>
 
 #include <stb/stb_image.h>
 #include <json/json.hpp>
 
+#include <memory>
 #include <string>
 
 namespace CubbyCity
 {
-inline std::string GetVectorTileURL(const Tile& tile, const std::string& apiKey)
+//! Returns a downloader reading from \p tileSource when it is not empty,
+//! otherwise the network downloader of the platform, retrying and rate
+//! limited according to \p policy.
+inline std::unique_ptr<IDownloader> CreateDownloader(
+    const std::string& tileSource,
+    const DownloadPolicy& policy = DownloadPolicy())
 {
-    return "https://tile.nextzen.org/tilezen/vector/v1/256/all/" +
-           std::to_string(tile.z) + "/" + std::to_string(tile.x) + "/" +
-           std::to_string(tile.y) + ".json?api_key=" + apiKey;
+    if (!tileSource.empty())
+    {
+        return std::make_unique<LocalDownloader>(tileSource);
+    }
+
+#if defined(CUBBYCITY_WINDOWS)
+    auto downloader = std::make_shared<WinDownloader>(policy.timeout,
+                                                      policy.connectTimeout);
+#else
+    auto downloader = std::make_shared<CurlDownloader>(policy.timeout,
+                                                       policy.connectTimeout);
+#endif
+
+    return std::make_unique<RetryingDownloader>(std::move(downloader), policy);
 }
 
-inline std::string GetTerrainURL(const Tile& tile, const std::string& apiKey)
+inline DownloadPolicy GetDownloadPolicy(const ProgramConfig& config)
 {
-    return "https://tile.nextzen.org/tilezen/terrain/v1/260/terrarium/" +
-           std::to_string(tile.z) + "/" + std::to_string(tile.x) + "/" +
-           std::to_string(tile.y) + ".png?api_key=" + apiKey;
+    DownloadPolicy policy;
+    policy.timeout = config.timeout;
+    policy.connectTimeout = config.connectTimeout;
+    policy.retries = config.downloadRetries;
+    policy.retryDelay = config.retryDelay;
+    policy.maxRetryDelay = config.maxRetryDelay;
+    policy.rateLimit = config.rateLimit;
+    policy.rateBurst = config.rateBurst;
+
+    return policy;
 }
 
-inline std::unique_ptr<HeightData> DownloadHeightmapTile(const std::string& url,
-                                                         double extrusionScale)
+inline std::unique_ptr<IDownloader> CreateDownloader(
+    const ProgramConfig& config)
 {
-#if defined(CUBBYCITY_WINDOWS)
-    WinDownloader downloader;
-#else
-    CurlDownloader downloader;
-#endif
-    std::string out;
+    return CreateDownloader(config.tileSource, GetDownloadPolicy(config));
+}
+
+inline bool DownloadPayload(IDownloader& downloader, Payload& out,
+                            const std::string& url, Profiler* profiler)
+{
+    ScopedTimer timer(profiler, "download");
+    const bool result = downloader.Download(out, url);
 
-    if (downloader.DownloadData(out, url))
+    if (profiler)
     {
+        profiler->AddCount("bytesDownloaded", out.Size());
+    }
+
+    return result;
+}
+
+inline std::unique_ptr<HeightData> DownloadHeightmapTile(
+    IDownloader& downloader, const std::string& url, double extrusionScale,
+    Profiler* profiler = nullptr)
+{
+    Payload out;
+
+    if (DownloadPayload(downloader, out, url, profiler))
+    {
+        ScopedTimer timer(profiler, "decode");
         int width, height, comp;
 
-        // Decode texture PNG
+        // Decode texture PNG straight from the payload
         const auto* pngData =
-            reinterpret_cast<const unsigned char*>(out.c_str());
-        unsigned char* pixels =
-            stbi_load_from_memory(pngData, static_cast<int>(out.length()),
-                                  &width, &height, &comp, STBI_rgb_alpha);
+            reinterpret_cast<const unsigned char*>(out.Data());
+        const std::unique_ptr<unsigned char, void (*)(void*)> pixels(
+            stbi_load_from_memory(pngData, static_cast<int>(out.Size()),
+                                  &width, &height, &comp, STBI_rgb_alpha),
+            stbi_image_free);
 
-        if (comp != STBI_rgb_alpha)
+        if (!pixels || comp != STBI_rgb_alpha)
         {
             return nullptr;
         }
@@ -76,7 +121,7 @@ inline std::unique_ptr<HeightData> DownloadHeightmapTile(const std::string& url,
         data->width = width;
         data->height = height;
 
-        unsigned char* pixel = pixels;
+        const unsigned char* pixel = pixels.get();
         for (int i = 0; i < width * height; ++i, pixel += 4)
         {
             const double red = *(pixel + 0);
@@ -100,20 +145,20 @@ inline std::unique_ptr<HeightData> DownloadHeightmapTile(const std::string& url,
     return nullptr;
 }
 
-inline std::unique_ptr<TileData> DownloadTile(const std::string& url,
-                                              const Tile& tile)
+inline std::unique_ptr<TileData> DownloadTile(IDownloader& downloader,
+                                              const std::string& url,
+                                              const Tile& tile,
+                                              Profiler* profiler = nullptr)
 {
-#if defined(CUBBYCITY_WINDOWS)
-    WinDownloader downloader;
-#else
-    CurlDownloader downloader;
-#endif
-    std::string out;
+    Payload out;
 
-    if (downloader.DownloadData(out, url))
+    if (DownloadPayload(downloader, out, url, profiler))
     {
-        // Parse written data into a JSON object
-        nlohmann::json j = nlohmann::json::parse(out);
+        ScopedTimer timer(profiler, "parse");
+
+        // Parse written data into a JSON object, reading it in place
+        nlohmann::json j =
+            nlohmann::json::parse(out.Data(), out.Data() + out.Size());
 
         if (j.is_null())
         {
@@ -121,10 +166,19 @@ inline std::unique_ptr<TileData> DownloadTile(const std::string& url,
         }
 
         std::unique_ptr<TileData> data = std::make_unique<TileData>();
+        data->layers.reserve(j.size());
+
         for (auto layer = j.begin(); layer != j.end(); ++layer)
         {
             data->layers.emplace_back(std::string(layer.key()));
-            GeoJSON::ExtractLayer(layer.value(), data->layers.back(), tile);
+            GeoJSON::ExtractLayer(layer.value(), data->layers.back(), *data,
+                                  tile);
+
+            if (profiler)
+            {
+                profiler->AddCount("features",
+                                   data->layers.back().features.size());
+            }
         }
 
         return data;
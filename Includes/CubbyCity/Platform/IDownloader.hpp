@@ -7,16 +7,71 @@
 #ifndef CUBBYCITY_IDOWNLOADER_HPP
 #define CUBBYCITY_IDOWNLOADER_HPP
 
+#include <CubbyCity/Platform/Payload.hpp>
+
 #include <string>
 
 namespace CubbyCity
 {
+//! Outcome of a single request.
+struct DownloadResult
+{
+    bool ok = false;
+
+    //! Whether the same request may succeed later: timeouts, connection
+    //! errors, HTTP 429 and 5xx.
+    bool transient = false;
+
+    //! HTTP status, 0 when there was no response.
+    int status = 0;
+
+    //! Delay asked for by the server with Retry-After, in seconds.
+    double retryAfter = 0.0;
+};
+
 class IDownloader
 {
  public:
     virtual ~IDownloader() = default;
 
     virtual bool DownloadData(std::string& out, const std::string& url) = 0;
+
+    //! Like DownloadData, into a buffer that can be shared, e.g. with a
+    //! cache, and read in place by the decoders.
+    virtual bool Download(Payload& out, const std::string& url)
+    {
+        std::string bytes;
+        const bool result = DownloadData(bytes, url);
+        out = Payload(std::move(bytes));
+
+        return result;
+    }
+
+    //! Like DownloadData, telling why a request failed. Downloaders that
+    //! cannot tell report every failure as permanent.
+    virtual DownloadResult Fetch(std::string& out, const std::string& url)
+    {
+        DownloadResult result;
+        result.ok = DownloadData(out, url);
+
+        return result;
+    }
+
+    //! Returns a string that changes whenever the content behind \p url
+    //! does, without fetching it. Remote content is assumed to be fixed for
+    //! a given URL.
+    virtual std::string GetVersion(const std::string& url)
+    {
+        return url;
+    }
+
+    //! Drops any copy of \p url kept by the downloader, e.g. after its
+    //! payload turned out to be unreadable, so that the next request
+    //! fetches it again.
+    virtual void Evict(const std::string& url)
+    {
+        (void)url;
+    }
 };
 }  // namespace CubbyCity
 
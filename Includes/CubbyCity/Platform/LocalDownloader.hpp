@@ -0,0 +1,43 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_LOCAL_DOWNLOADER_HPP
+#define CUBBYCITY_LOCAL_DOWNLOADER_HPP
+
+#include <CubbyCity/Platform/IDownloader.hpp>
+
+namespace CubbyCity
+{
+//!
+//! Serves tile requests from a local directory instead of the network. A URL
+//! "https://host/a/b.json?query" is read from "<root>/host/a/b.json", the
+//! layout written by "wget --force-directories", so recorded tiles can be
+//! replayed as they are.
+//!
+class LocalDownloader : public IDownloader
+{
+ public:
+    explicit LocalDownloader(std::string rootDir);
+
+    bool DownloadData(std::string& out, const std::string& url) override;
+
+    //! Maps the tile file read-only instead of reading it, so the decoders
+    //! work on the page cache and concurrent processes share its pages. The
+    //! file must not be truncated while the payload is alive; replacing it
+    //! by a rename, as DiskCachingDownloader does, is safe.
+    bool Download(Payload& out, const std::string& url) override;
+
+    //! The file size and modification time of the tile.
+    std::string GetVersion(const std::string& url) override;
+
+    std::string GetFilePath(const std::string& url) const;
+
+ private:
+    std::string m_rootDir;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_LOCAL_DOWNLOADER_HPP
\ No newline at end of file
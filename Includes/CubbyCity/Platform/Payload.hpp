@@ -0,0 +1,64 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_PAYLOAD_HPP
+#define CUBBYCITY_PAYLOAD_HPP
+
+#include <memory>
+#include <string>
+
+namespace CubbyCity
+{
+//!
+//! Read-only bytes of a downloaded tile. Copies share the bytes instead of
+//! duplicating them, so a payload can go from the downloader through caches
+//! to the decoders without being copied.
+//!
+class Payload
+{
+ public:
+    Payload() = default;
+
+    //! Takes over the bytes of \p bytes.
+    explicit Payload(std::string bytes)
+    {
+        auto buffer = std::make_shared<const std::string>(std::move(bytes));
+
+        m_data = buffer->data();
+        m_size = buffer->size();
+        m_owner = std::move(buffer);
+    }
+
+    //! Views \p size bytes at \p data, which \p owner keeps alive.
+    Payload(std::shared_ptr<const void> owner, const char* data, size_t size)
+        : m_owner(std::move(owner)), m_data(data), m_size(size)
+    {
+        // Do nothing
+    }
+
+    const char* Data() const
+    {
+        return m_data;
+    }
+
+    size_t Size() const
+    {
+        return m_size;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+ private:
+    std::shared_ptr<const void> m_owner;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_PAYLOAD_HPP
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_RETRYING_DOWNLOADER_HPP
+#define CUBBYCITY_RETRYING_DOWNLOADER_HPP
+
+#include <CubbyCity/Commons/TokenBucket.hpp>
+#include <CubbyCity/Platform/IDownloader.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace CubbyCity
+{
+struct DownloadPolicy
+{
+    //! Request timeouts in seconds, 0 waits forever.
+    double timeout = 30.0;
+    double connectTimeout = 10.0;
+
+    //! Attempts after a transient failure. The n-th retry waits a random
+    //! time up to retryDelay * 2^n, capped at maxRetryDelay, or longer when
+    //! the server asks for it. A request the server asks to retry after more
+    //! than maxRetryDelay fails at once.
+    int retries = 4;
+    double retryDelay = 0.5;
+    double maxRetryDelay = 30.0;
+
+    //! Requests per second to each host, 0 does not limit, and the number of
+    //! requests that may go out at once after an idle time.
+    double rateLimit = 0.0;
+    double rateBurst = 8.0;
+
+    bool operator==(const DownloadPolicy& rhs) const
+    {
+        return timeout == rhs.timeout &&
+               connectTimeout == rhs.connectTimeout &&
+               retries == rhs.retries && retryDelay == rhs.retryDelay &&
+               maxRetryDelay == rhs.maxRetryDelay &&
+               rateLimit == rhs.rateLimit && rateBurst == rhs.rateBurst;
+    }
+};
+
+//!
+//! Wraps a network downloader with retries of transient failures, using
+//! exponential backoff with full jitter, and a token bucket per host. A
+//! Retry-After answer holds back every request to that host, not only the
+//! one that got it. Safe to use from several threads when the wrapped
+//! downloader is.
+//!
+class RetryingDownloader : public IDownloader
+{
+ public:
+    RetryingDownloader(std::shared_ptr<IDownloader> downloader,
+                       DownloadPolicy policy);
+
+    bool DownloadData(std::string& out, const std::string& url) override;
+
+    DownloadResult Fetch(std::string& out, const std::string& url) override;
+
+    std::string GetVersion(const std::string& url) override;
+
+    void Evict(const std::string& url) override;
+
+    size_t GetNumRetries() const;
+
+ private:
+    TokenBucket& GetBucket(const std::string& url);
+
+    std::shared_ptr<IDownloader> m_downloader;
+    DownloadPolicy m_policy;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<TokenBucket>> m_buckets;
+    std::atomic<size_t> m_numRetries{ 0 };
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_RETRYING_DOWNLOADER_HPP
\ No newline at end of file
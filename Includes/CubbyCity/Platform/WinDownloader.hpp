@@ -14,7 +14,16 @@ namespace CubbyCity
 class WinDownloader : public IDownloader
 {
  public:
+    //! Timeouts are given in seconds, 0 waits forever.
+    explicit WinDownloader(double timeout = 0.0, double connectTimeout = 0.0);
+
     bool DownloadData(std::string& out, const std::string& url) override;
+
+    DownloadResult Fetch(std::string& out, const std::string& url) override;
+
+ private:
+    double m_timeout;
+    double m_connectTimeout;
 };
 }  // namespace CubbyCity
 
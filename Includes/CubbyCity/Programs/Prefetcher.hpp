@@ -0,0 +1,46 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_PREFETCHER_HPP
+#define CUBBYCITY_PREFETCHER_HPP
+
+#include <CubbyCity/Platform/IDownloader.hpp>
+#include <CubbyCity/Programs/Profiler.hpp>
+#include <CubbyCity/Programs/ProgramConfig.hpp>
+
+#include <json/json.hpp>
+
+#include <memory>
+
+namespace CubbyCity
+{
+//!
+//! Fills the tile cache directory ahead of a job, without building any
+//! geometry. The tiles of the region, or of the tile range when no region
+//! is given, are enumerated at every zoom of the prefetch range. The
+//! payloads missing from the cache are fetched on several threads, so that
+//! a later run finds every tile on disk.
+//!
+class Prefetcher
+{
+ public:
+    explicit Prefetcher(ProgramConfig config,
+                        std::shared_ptr<IDownloader> downloader = nullptr);
+
+    //! Fetches the missing payloads and returns the coverage of the cache
+    //! per zoom level, with the payloads that could not be fetched.
+    nlohmann::json Run();
+
+    const Profiler& GetProfiler() const;
+
+ private:
+    ProgramConfig m_config;
+    std::shared_ptr<IDownloader> m_downloader;
+    Profiler m_profiler;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_PREFETCHER_HPP
\ No newline at end of file
@@ -0,0 +1,126 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_PROFILER_HPP
+#define CUBBYCITY_PROFILER_HPP
+
+#include <json/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CubbyCity
+{
+//!
+//! Accumulates wall time per pipeline stage and named counters of a run.
+//! When tracing is enabled it also keeps every span with its thread, to be
+//! saved in the Chrome trace event format. Safe to update from several
+//! threads.
+//!
+class Profiler
+{
+ public:
+    using Clock = std::chrono::steady_clock;
+
+    Profiler();
+
+    void AddTime(const std::string& stage, double seconds);
+    void AddCount(const std::string& counter, std::uint64_t value = 1);
+
+    double GetSeconds(const std::string& stage) const;
+    std::uint64_t GetCalls(const std::string& stage) const;
+    std::uint64_t GetCount(const std::string& counter) const;
+
+    nlohmann::json ToJSON() const;
+    void SaveJSON(const std::string& fileName) const;
+
+    void EnableTrace(bool enable);
+    bool IsTraceEnabled() const;
+
+    void AddTraceEvent(const std::string& name, const std::string& category,
+                       Clock::time_point start, Clock::time_point end);
+
+    nlohmann::json ToChromeTrace() const;
+    void SaveChromeTrace(const std::string& fileName) const;
+
+    void Reset();
+
+ private:
+    struct Stage
+    {
+        double seconds = 0.0;
+        std::uint64_t calls = 0;
+    };
+
+    struct TraceEvent
+    {
+        std::string name;
+        std::string category;
+        std::uint32_t threadID;
+        double start;
+        double duration;
+    };
+
+    std::uint32_t GetThreadID();
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Stage> m_stages;
+    std::map<std::string, std::uint64_t> m_counters;
+
+    std::atomic<bool> m_traceEnabled{ false };
+    Clock::time_point m_epoch;
+    std::vector<TraceEvent> m_traceEvents;
+    std::map<std::thread::id, std::uint32_t> m_threadIDs;
+};
+
+//!
+//! Adds the lifetime of the object to a stage of the profiler. Does nothing
+//! when the profiler is null.
+//!
+class ScopedTimer
+{
+ public:
+    ScopedTimer(Profiler* profiler, std::string stage);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+    Profiler* m_profiler;
+    std::string m_stage;
+    Profiler::Clock::time_point m_start;
+};
+
+//!
+//! Records the lifetime of the object as a trace span without adding it to
+//! the stage totals, e.g. one span per tile. Does nothing unless tracing is
+//! enabled.
+//!
+class ScopedTrace
+{
+ public:
+    ScopedTrace(Profiler* profiler, std::string name, std::string category);
+    ~ScopedTrace();
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+    Profiler* m_profiler;
+    std::string m_name;
+    std::string m_category;
+    Profiler::Clock::time_point m_start;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_PROFILER_HPP
\ No newline at end of file
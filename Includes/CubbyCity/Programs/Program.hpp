@@ -15,10 +15,16 @@ namespace CubbyCity
 class Program
 {
  public:
-    explicit Program(ProgramConfig config);
+    //! Tiles are fetched through \p downloader and decoded tiles are shared
+    //! through \p tileCache when given, e.g. by the jobs of a job file.
+    explicit Program(ProgramConfig config,
+                     std::shared_ptr<IDownloader> downloader = nullptr,
+                     std::shared_ptr<TileCache> tileCache = nullptr);
 
     void Process();
 
+    const Profiler& GetProfiler() const;
+
  private:
     ProgramConfig m_config;
     Geometry m_geometry;
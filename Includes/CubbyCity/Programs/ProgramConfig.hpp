@@ -7,6 +7,9 @@
 #ifndef CUBBYCITY_PROGRAM_CONFIG_HPP
 #define CUBBYCITY_PROGRAM_CONFIG_HPP
 
+#include <CubbyCity/Geometry/CityGenerator.hpp>
+#include <CubbyCity/Geometry/GeometryData.hpp>
+
 #include <string>
 
 namespace CubbyCity
@@ -14,10 +17,17 @@ namespace CubbyCity
 struct ProgramConfig
 {
     std::string apiKey;
+    std::string tileSource;
+    std::string tileEndpoint;
 
     std::string tileX;
     std::string tileY;
     int tileZ;
+    std::string region;
+    std::string regionFile;
+    std::string prefetchZoom;
+    int prefetchThreads;
+    int maxTiles;
 
     int terrainSubdivision;
     double terrainExtrusionScale;
@@ -26,18 +36,49 @@ struct ProgramConfig
     double roadsHeight;
     double roadsExtrusionWidth;
     double pedestalHeight;
+    double simplifyRatio;
+    double simplifyMaxError;
+    int downloadCacheSize;
+    int decodedCacheSize;
+    int serverCacheSize;
+    int retries;
+
+    double timeout;
+    double connectTimeout;
+    int downloadRetries;
+    double retryDelay;
+    double maxRetryDelay;
+    double rateLimit;
+    double rateBurst;
+
+    NormalWeighting normalWeighting;
+    CityGeneratorConfig cityGenerator;
 
     std::string fileName;
+    std::string profileFile;
+    std::string traceFile;
+    std::string meshCacheDir;
+    std::string tileCacheDir;
     double offsetX;
     double offsetY;
 
     bool terrain;
     bool buildings;
     bool roads;
+    bool clipToTile;
     bool pedestal;
     bool normals;
+    bool simplify;
+    bool batchMeshes;
+    bool featureIds;
     bool splitMesh;
     bool append;
+    bool synthetic;
+    bool incremental;
+    bool checkpoint;
+    bool resume;
+    bool skipFailedTiles;
+    bool prefetch;
 };
 }  // namespace CubbyCity
 
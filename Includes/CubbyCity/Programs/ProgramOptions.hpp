@@ -0,0 +1,55 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_PROGRAM_OPTIONS_HPP
+#define CUBBYCITY_PROGRAM_OPTIONS_HPP
+
+#include <CubbyCity/Programs/ProgramConfig.hpp>
+
+#include <json/json.hpp>
+
+#include <string>
+#include <vector>
+
+namespace CubbyCity
+{
+//!
+//! Named options over the ProgramConfig fields, shared by the command line
+//! ("--tileX 19294", "--terrain", "--normals=false") and job files. Option
+//! names are the field names; generator settings are prefixed with "city.".
+//!
+class ProgramOptions
+{
+ public:
+    //! Returns the configuration used when an option is not given.
+    static ProgramConfig GetDefaultConfig();
+
+    //! Sets the option \p name from its textual \p value. Throws
+    //! std::invalid_argument on unknown options and malformed values.
+    static void Set(ProgramConfig& config, const std::string& name,
+                    const std::string& value);
+
+    static bool Has(const std::string& name);
+    static bool IsFlag(const std::string& name);
+
+    //! Sets every member of the JSON object \p options.
+    static void Apply(ProgramConfig& config, const nlohmann::json& options);
+
+    //! Returns every option of \p config as a string, in a stable order, so
+    //! that equal configurations give equal dumps.
+    static nlohmann::json ToJSON(const ProgramConfig& config);
+
+    //! Reads a job file, an object with an optional "defaults" object and a
+    //! "jobs" array of objects. Each job starts from \p base, then the
+    //! defaults, then its own options.
+    static std::vector<ProgramConfig> LoadJobFile(const std::string& fileName,
+                                                  const ProgramConfig& base);
+
+    static std::string GetUsage();
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_PROGRAM_OPTIONS_HPP
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef CUBBYCITY_TILE_SERVER_HPP
+#define CUBBYCITY_TILE_SERVER_HPP
+
+#include <CubbyCity/Commons/LRUCache.hpp>
+#include <CubbyCity/Geometry/TileCache.hpp>
+#include <CubbyCity/Platform/IDownloader.hpp>
+#include <CubbyCity/Programs/ProgramConfig.hpp>
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CubbyCity
+{
+//!
+//! Serves meshes over HTTP on the loopback interface, keeping decoded tiles
+//! and finished meshes in memory between requests.
+//!
+//! GET /tile/{z}/{x}/{y}.obj builds a single tile and GET /region.obj a tile
+//! range given by the tileX, tileY and tileZ parameters, or the tiles at
+//! tileZ within a region bounding box. The geometry and output options,
+//! such as terrain, roads, normals or simplify, can be passed as query
+//! parameters ("?terrain=true&normals=true") on top of the configuration
+//! the server was started with, within narrower ranges than on the command
+//! line. Any other option is rejected with 403, an out of range value or a
+//! request of more than 64 tiles with 400, and any method but GET with 405.
+//!
+class TileServer
+{
+ public:
+    struct Response
+    {
+        int status = 200;
+        std::string contentType = "text/plain";
+        std::shared_ptr<const std::string> body;
+        bool cached = false;
+
+        //! Header fields besides the content and cache ones, e.g. Allow.
+        std::vector<std::pair<std::string, std::string>> headers;
+    };
+
+    //! \p cacheBytes is split evenly between the tile cache and the mesh
+    //! cache.
+    TileServer(ProgramConfig config, std::shared_ptr<IDownloader> downloader,
+               size_t cacheBytes);
+
+    //! Accepts connections on 127.0.0.1:\p port until the process ends.
+    void Run(unsigned short port);
+
+    //! Handles a request target such as "/tile/16/19294/24642.obj?roads=1".
+    Response Handle(const std::string& target);
+
+ private:
+    Response Build(const ProgramConfig& config,
+                   const std::vector<glm::ivec2>& tiles);
+
+    ProgramConfig m_config;
+    std::shared_ptr<IDownloader> m_downloader;
+    std::shared_ptr<TileCache> m_tileCache;
+    LRUCache<std::string, std::shared_ptr<const std::string>> m_meshCache;
+};
+}  // namespace CubbyCity
+
+#endif  // CUBBYCITY_TILE_SERVER_HPP
\ No newline at end of file
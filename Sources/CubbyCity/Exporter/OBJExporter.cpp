@@ -71,115 +71,134 @@ void OBJExporter::Save(const std::string& outputOBJ, bool splitMeshes,
 
     if (file.is_open())
     {
-        size_t nVertex = 0;
-        size_t nTriangles = 0;
+        Write(file, outputOBJ, splitMeshes, meshes, offsetX, offsetY, normals,
+              maxIndex);
 
-        file << "# exported with CubbyCity: "
-                "https://github.com/utilForever/CubbyCity"
-             << "\n";
-        file << "\n";
+        file.close();
+    }
+}
 
-        size_t indexOffset = maxIndex;
+void OBJExporter::Write(std::ostream& file, const std::string& objectName,
+                        bool splitMeshes,
+                        const std::vector<std::unique_ptr<PolygonMesh>>& meshes,
+                        double offsetX, double offsetY, bool normals,
+                        size_t indexOffset) const
+{
+    size_t nVertex = 0;
+    size_t nTriangles = 0;
 
-        if (splitMeshes)
-        {
-            int meshCnt = 0;
+    file << "# exported with CubbyCity: "
+            "https://github.com/utilForever/CubbyCity"
+         << "\n";
+    file << "\n";
 
-            for (const auto& mesh : meshes)
+    if (splitMeshes)
+    {
+        int meshCnt = 0;
+
+        for (const auto& mesh : meshes)
+        {
+            if (mesh->positions.empty())
             {
-                if (mesh->vertices.empty())
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                file << "o mesh" << meshCnt++ << "\n";
+            file << "o mesh" << meshCnt++ << "\n";
 
-                AddPositions(file, *mesh, offsetX, offsetY);
-                nVertex += mesh->vertices.size();
+            AddPositions(file, *mesh, offsetX, offsetY);
+            nVertex += mesh->positions.size();
 
-                if (normals)
-                {
-                    AddNormals(file, *mesh);
-                }
+            if (normals)
+            {
+                AddNormals(file, *mesh);
+            }
 
-                AddFaces(file, *mesh, indexOffset, normals);
-                nTriangles += mesh->indices.size() / 3;
+            AddFaces(file, *mesh, indexOffset, normals);
+            nTriangles += mesh->indices.size() / 3;
 
-                file << "\n";
+            file << "\n";
 
-                indexOffset += mesh->vertices.size();
-            }
+            indexOffset += mesh->positions.size();
         }
-        else
-        {
-            file << "o " << outputOBJ << "\n";
+    }
+    else
+    {
+        file << "o " << objectName << "\n";
 
-            for (const auto& mesh : meshes)
+        for (const auto& mesh : meshes)
+        {
+            if (mesh->positions.empty())
             {
-                if (mesh->vertices.empty())
-                {
-                    continue;
-                }
-
-                AddPositions(file, *mesh, offsetX, offsetY);
-                nVertex += mesh->vertices.size();
+                continue;
             }
 
-            if (normals)
-            {
-                for (const auto& mesh : meshes)
-                {
-                    if (mesh->vertices.empty())
-                    {
-                        continue;
-                    }
-
-                    AddNormals(file, *mesh);
-                }
-            }
+            AddPositions(file, *mesh, offsetX, offsetY);
+            nVertex += mesh->positions.size();
+        }
 
+        if (normals)
+        {
             for (const auto& mesh : meshes)
             {
-                if (mesh->vertices.empty())
+                if (mesh->positions.empty())
                 {
                     continue;
                 }
 
-                AddFaces(file, *mesh, indexOffset, normals);
-                indexOffset += mesh->vertices.size();
-                nTriangles += mesh->indices.size() / 3;
+                AddNormals(file, *mesh);
             }
         }
 
-        file.close();
+        for (const auto& mesh : meshes)
+        {
+            if (mesh->positions.empty())
+            {
+                continue;
+            }
+
+            AddFaces(file, *mesh, indexOffset, normals);
+            indexOffset += mesh->positions.size();
+            nTriangles += mesh->indices.size() / 3;
+        }
     }
 }
 
 void OBJExporter::AddPositions(std::ostream& file, const PolygonMesh& mesh,
                                double offsetX, double offsetY) const
 {
-    for (auto vertex : mesh.vertices)
+    for (const auto& position : mesh.positions)
     {
-        file << "v " << vertex.position.x + offsetX + mesh.offset.x << " "
-             << vertex.position.y + offsetY + mesh.offset.y << " "
-             << vertex.position.z << "\n";
+        file << "v " << position.x + offsetX + mesh.offset.x << " "
+             << position.y + offsetY + mesh.offset.y << " " << position.z
+             << "\n";
     }
 }
 
 void OBJExporter::AddNormals(std::ostream& file, const PolygonMesh& mesh) const
 {
-    for (auto vertex : mesh.vertices)
+    for (const auto& normal : mesh.normals)
     {
-        file << "vn " << vertex.normal.x << " " << vertex.normal.y << " "
-             << vertex.normal.z << "\n";
+        file << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
     }
 }
 
 void OBJExporter::AddFaces(std::ostream& file, const PolygonMesh& mesh,
                            size_t indexOffset, bool normals) const
 {
+    const bool hasFeatureIds = !mesh.featureIds.empty();
+    unsigned int featureId = 0;
+
     for (size_t i = 0; i < mesh.indices.size(); i += 3)
     {
+        // Group faces by source feature so batched meshes can be picked;
+        // ids restart in every tile and layer, which name the group
+        if (hasFeatureIds &&
+            (i == 0 || mesh.featureIds[mesh.indices[i]] != featureId))
+        {
+            featureId = mesh.featureIds[mesh.indices[i]];
+            file << "g " << mesh.featureGroup << "_" << featureId << "\n";
+        }
+
         file << "f " << mesh.indices[i] + indexOffset + 1
              << (normals
                      ? "//" + std::to_string(mesh.indices[i] + indexOffset + 1)
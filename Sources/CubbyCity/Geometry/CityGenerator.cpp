@@ -0,0 +1,228 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Geometry/CityGenerator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace CubbyCity
+{
+namespace
+{
+std::uint32_t Mix(std::uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+
+    return h;
+}
+
+std::uint32_t Hash(std::int32_t x, std::int32_t y, std::uint32_t seed)
+{
+    return Mix(static_cast<std::uint32_t>(x) ^
+               Mix(static_cast<std::uint32_t>(y) ^ Mix(seed)));
+}
+
+double SmoothStep(double t)
+{
+    return t * t * (3.0 - 2.0 * t);
+}
+}  // namespace
+
+CityGenerator::CityGenerator(CityGeneratorConfig config)
+    : m_config(std::move(config))
+{
+    // Do nothing
+}
+
+std::unique_ptr<HeightData> CityGenerator::GenerateHeightData(
+    const Tile& tile, double extrusionScale) const
+{
+    const int size = std::max(2, m_config.heightmapSize);
+
+    auto data = std::make_unique<HeightData>();
+    data->width = size;
+    data->height = size;
+    data->elevation.resize(size, std::vector<double>(size));
+
+    // Samples on the tile edges land on the same global coordinates as those
+    // of the neighbor tile
+    const double step = 1.0 / (size - 1);
+
+    for (int x = 0; x < size; ++x)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            data->elevation[x][y] =
+                GetElevation(tile.x + x * step, tile.y + y * step) *
+                extrusionScale;
+        }
+    }
+
+    return data;
+}
+
+std::unique_ptr<TileData> CityGenerator::GenerateTileData(
+    const Tile& tile) const
+{
+    auto data = std::make_unique<TileData>();
+
+    AddBuildings(*data, tile);
+    AddRoads(*data, tile);
+
+    return data;
+}
+
+double CityGenerator::GetElevation(double x, double y) const
+{
+    const double roughness =
+        std::min(std::max(m_config.terrainRoughness, 0.0), 1.0);
+
+    double sum = 0.0;
+    double weight = 1.0;
+    double totalWeight = 0.0;
+    double frequency = 0.5;
+
+    for (unsigned int octave = 0; octave < 6; ++octave)
+    {
+        sum += weight * GetNoise(x * frequency, y * frequency, octave);
+        totalWeight += weight;
+        weight *= roughness;
+        frequency *= 2.0;
+    }
+
+    return 100.0 + m_config.terrainAmplitude * sum / totalWeight;
+}
+
+double CityGenerator::GetNoise(double x, double y, unsigned int octave) const
+{
+    const double fx = std::floor(x);
+    const double fy = std::floor(y);
+    const auto ix = static_cast<std::int32_t>(fx);
+    const auto iy = static_cast<std::int32_t>(fy);
+    const std::uint32_t seed = m_config.seed * 16 + octave;
+
+    auto lattice = [seed](std::int32_t i, std::int32_t j) {
+        return Hash(i, j, seed) * (2.0 / 4294967295.0) - 1.0;
+    };
+
+    const double tx = SmoothStep(x - fx);
+    const double ty = SmoothStep(y - fy);
+
+    const double v0 =
+        lattice(ix, iy) + (lattice(ix + 1, iy) - lattice(ix, iy)) * tx;
+    const double v1 = lattice(ix, iy + 1) +
+                      (lattice(ix + 1, iy + 1) - lattice(ix, iy + 1)) * tx;
+
+    return v0 + (v1 - v0) * ty;
+}
+
+void CityGenerator::AddBuildings(TileData& data, const Tile& tile) const
+{
+    const int numBuildings = std::max(0, m_config.buildingsPerTile);
+    const int numVertices = std::max(3, m_config.footprintVertices);
+
+    std::mt19937 rng(GetTileSeed(tile, 0));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const int blocks =
+        static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numBuildings))));
+    const double blockSize = 2.0 / std::max(1, blocks);
+
+    data.layers.emplace_back("buildings");
+    Layer& layer = data.layers.back();
+    layer.features.reserve(numBuildings);
+    data.points.reserve(data.points.size() +
+                        static_cast<size_t>(numBuildings) * (numVertices + 1));
+
+    for (int i = 0; i < numBuildings; ++i)
+    {
+        const double cx =
+            -1.0 + (i % blocks + 0.4 + 0.2 * unit(rng)) * blockSize;
+        const double cy =
+            -1.0 + (i / blocks + 0.4 + 0.2 * unit(rng)) * blockSize;
+        const double radius = blockSize * (0.2 + 0.1 * unit(rng));
+        const double rotation = 2.0 * MATH_PI * unit(rng);
+
+        const size_t offset = data.points.size();
+
+        for (int v = 0; v < numVertices; ++v)
+        {
+            const double angle = rotation + 2.0 * MATH_PI * v / numVertices;
+            const double r = radius * (0.85 + 0.15 * unit(rng));
+            data.points.emplace_back(cx + r * std::cos(angle),
+                                     cy + r * std::sin(angle), 0.0);
+        }
+
+        // Close the ring as GeoJSON does
+        data.points.push_back(data.points[offset]);
+
+        Feature feature;
+        feature.geometryType = GeometryType::Polygons;
+        feature.polygons = { data.polygons.size(), 1 };
+        feature.props.numericProps["height"] = 6.0 + 54.0 * unit(rng);
+        feature.props.numericProps["min_height"] = 0.0;
+
+        // The ring belongs to the polygon only, lest it is built as a road
+        data.polygons.push_back({ data.lines.size(), 1 });
+        data.lines.push_back(
+            { offset, static_cast<size_t>(numVertices) + 1 });
+        layer.features.push_back(std::move(feature));
+    }
+}
+
+void CityGenerator::AddRoads(TileData& data, const Tile& tile) const
+{
+    const int numRoads = std::max(0, m_config.roadsPerTile);
+    const int numPoints = std::max(2, m_config.roadPoints);
+
+    std::mt19937 rng(GetTileSeed(tile, 1));
+    std::uniform_real_distribution<double> wobble(-0.002, 0.002);
+
+    // Half of the roads run east-west, the other half north-south
+    const int perAxis = (numRoads + 1) / 2;
+
+    data.layers.emplace_back("roads");
+    Layer& layer = data.layers.back();
+    layer.features.reserve(numRoads);
+
+    for (int i = 0; i < numRoads; ++i)
+    {
+        const bool horizontal = i % 2 == 0;
+        const double position = -1.0 + 2.0 * (i / 2 + 0.5) / perAxis;
+        const size_t offset = data.points.size();
+
+        for (int p = 0; p < numPoints; ++p)
+        {
+            const double t = -1.0 + 2.0 * p / (numPoints - 1);
+            const double s = position + wobble(rng);
+
+            data.points.emplace_back(horizontal ? t : s, horizontal ? s : t,
+                                     0.0);
+        }
+
+        Feature feature;
+        feature.geometryType = GeometryType::Lines;
+        feature.lines = { data.lines.size(), 1 };
+
+        data.lines.push_back({ offset, static_cast<size_t>(numPoints) });
+        layer.features.push_back(std::move(feature));
+    }
+}
+
+unsigned int CityGenerator::GetTileSeed(const Tile& tile,
+                                        unsigned int salt) const
+{
+    return Hash(tile.x, tile.y, Mix(m_config.seed) ^ Mix(tile.z * 2 + salt));
+}
+}  // namespace CubbyCity
\ No newline at end of file
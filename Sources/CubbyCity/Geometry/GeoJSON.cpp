@@ -6,6 +6,8 @@
 
 #include <CubbyCity/Geometry/GeoJSON.hpp>
 
+#include <vector>
+
 namespace CubbyCity
 {
 bool GeoJSON::ExtractPoint(const nlohmann::json::value_type& in, Point& out,
@@ -19,38 +21,60 @@ bool GeoJSON::ExtractPoint(const nlohmann::json::value_type& in, Point& out,
     return !(last && glm::length(out - *last) < 1e-5f);
 }
 
-void GeoJSON::ExtractLine(const nlohmann::json::value_type& in, Line& out,
-                          const Tile& tile)
+void GeoJSON::ExtractLine(const nlohmann::json::value_type& in,
+                          TileData& data, const Tile& tile)
 {
-    for (const auto& points : in)
+    // Scratch buffers reused across lines, projected as a whole
+    thread_local std::vector<double> xs;
+    thread_local std::vector<double> ys;
+
+    xs.clear();
+    ys.clear();
+
+    for (const auto& coords : in)
     {
-        out.emplace_back();
-        if (out.size() > 1)
-        {
-            if (!ExtractPoint(points, out.back(), tile, &out[out.size() - 2]))
-            {
-                out.pop_back();
-            }
-        }
-        else
+        xs.push_back(coords[0].get<double>());
+        ys.push_back(coords[1].get<double>());
+    }
+
+    ConvertLonLatToTile(xs.data(), ys.data(), xs.size(), tile.tileOrigin,
+                        tile.invScale);
+
+    auto& points = data.points;
+    const size_t offset = points.size();
+
+    for (size_t i = 0; i < xs.size(); ++i)
+    {
+        const Point point(xs[i], ys[i], 0.0);
+
+        // Skip points too close to the previous one
+        if (points.size() > offset &&
+            glm::length(point - points.back()) < EPSILON)
         {
-            ExtractPoint(points, out.back(), tile);
+            continue;
         }
+
+        points.push_back(point);
     }
+
+    data.lines.push_back({ offset, points.size() - offset });
 }
 
-void GeoJSON::ExtractPolygon(const nlohmann::json::value_type& in, Polygon& out,
-                             const Tile& tile)
+void GeoJSON::ExtractPolygon(const nlohmann::json::value_type& in,
+                             TileData& data, const Tile& tile)
 {
+    const size_t offset = data.lines.size();
+
     for (const auto& lines : in)
     {
-        out.emplace_back();
-        ExtractLine(lines, out.back(), tile);
+        ExtractLine(lines, data, tile);
     }
+
+    data.polygons.push_back({ offset, data.lines.size() - offset });
 }
 
 void GeoJSON::ExtractFeature(const nlohmann::json::value_type& in, Feature& out,
-                             const Tile& tile)
+                             TileData& data, const Tile& tile)
 {
     const nlohmann::json::value_type& properties = in["properties"];
 
@@ -77,57 +101,64 @@ void GeoJSON::ExtractFeature(const nlohmann::json::value_type& in, Feature& out,
     if (geometryType == "Point")
     {
         out.geometryType = GeometryType::Points;
-        out.points.emplace_back();
-        if (!ExtractPoint(coords, out.points.back(), tile))
+        out.points.offset = data.points.size();
+        data.points.emplace_back();
+        if (!ExtractPoint(coords, data.points.back(), tile))
         {
-            out.points.pop_back();
+            data.points.pop_back();
         }
+        out.points.count = data.points.size() - out.points.offset;
     }
     else if (geometryType == "MultiPoint")
     {
         out.geometryType = GeometryType::Points;
+        out.points.offset = data.points.size();
         for (const auto& pointCoords : coords)
         {
-            if (!ExtractPoint(pointCoords, out.points.back(), tile))
+            data.points.emplace_back();
+            if (!ExtractPoint(pointCoords, data.points.back(), tile))
             {
-                out.points.pop_back();
+                data.points.pop_back();
             }
         }
+        out.points.count = data.points.size() - out.points.offset;
     }
     else if (geometryType == "LineString")
     {
         out.geometryType = GeometryType::Lines;
-        out.lines.emplace_back();
-        ExtractLine(coords, out.lines.back(), tile);
+        out.lines = { data.lines.size(), 1 };
+        ExtractLine(coords, data, tile);
     }
     else if (geometryType == "MultiLineString")
     {
         out.geometryType = GeometryType::Lines;
+        out.lines.offset = data.lines.size();
         for (const auto& lineCoords : coords)
         {
-            out.lines.emplace_back();
-            ExtractLine(lineCoords, out.lines.back(), tile);
+            ExtractLine(lineCoords, data, tile);
         }
+        out.lines.count = data.lines.size() - out.lines.offset;
     }
     else if (geometryType == "Polygon")
     {
         out.geometryType = GeometryType::Polygons;
-        out.polygons.emplace_back();
-        ExtractPolygon(coords, out.polygons.back(), tile);
+        out.polygons = { data.polygons.size(), 1 };
+        ExtractPolygon(coords, data, tile);
     }
     else if (geometryType == "MultiPolygon")
     {
         out.geometryType = GeometryType::Polygons;
+        out.polygons.offset = data.polygons.size();
         for (const auto& polyCoords : coords)
         {
-            out.polygons.emplace_back();
-            ExtractPolygon(polyCoords, out.polygons.back(), tile);
+            ExtractPolygon(polyCoords, data, tile);
         }
+        out.polygons.count = data.polygons.size() - out.polygons.offset;
     }
 }
 
 void GeoJSON::ExtractLayer(const nlohmann::json::value_type& in, Layer& out,
-                           const Tile& tile)
+                           TileData& data, const Tile& tile)
 {
     const nlohmann::json::value_type& features = in["features"];
     if (features.is_null())
@@ -135,10 +166,12 @@ void GeoJSON::ExtractLayer(const nlohmann::json::value_type& in, Layer& out,
         return;
     }
 
+    out.features.reserve(features.size());
+
     for (const auto& feature : features)
     {
         out.features.emplace_back();
-        ExtractFeature(feature, out.features.back(), tile);
+        ExtractFeature(feature, out.features.back(), data, tile);
     }
 }
 }  // namespace CubbyCity
\ No newline at end of file
@@ -6,16 +6,57 @@
 
 #include <CubbyCity/Exporter/OBJExporter.hpp>
 #include <CubbyCity/Geometry/Geometry.hpp>
+#include <CubbyCity/Geometry/MeshSimplifier.hpp>
+#include <CubbyCity/Geometry/TileCover.hpp>
 #include <CubbyCity/Geometry/TileUtils.hpp>
+#include <CubbyCity/Platform/DiskCachingDownloader.hpp>
 #include <CubbyCity/Platform/DownloadUtils.hpp>
+#include <CubbyCity/Platform/TileURLs.hpp>
+#include <CubbyCity/Programs/ProgramOptions.hpp>
 
 #include <mapbox/earcut.hpp>
 
+// The stb_image implementation lives in this translation unit only
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <stdexcept>
 #include <utility>
 
+namespace mapbox::util
+{
+// Let earcut read tile-space points directly from the tile geometry arena
+template <>
+struct nth<0, CubbyCity::Point>
+{
+    static double get(const CubbyCity::Point& point)
+    {
+        return point.x;
+    }
+};
+
+template <>
+struct nth<1, CubbyCity::Point>
+{
+    static double get(const CubbyCity::Point& point)
+    {
+        return point.y;
+    }
+};
+}  // namespace mapbox::util
+
 namespace CubbyCity
 {
-Geometry::Geometry(ProgramConfig config) : m_config(std::move(config))
+Geometry::Geometry(ProgramConfig config,
+                   std::shared_ptr<IDownloader> downloader,
+                   std::shared_ptr<TileCache> tileCache)
+    : m_config(std::move(config)),
+      m_downloader(std::move(downloader)),
+      m_tileCache(std::move(tileCache))
 {
     // Do nothing
 }
@@ -26,72 +67,267 @@ void Geometry::ParseTiles(const std::string& tileX, const std::string& tileY,
     auto [startX, endX] = ExtractTileRange(tileX);
     auto [startY, endY] = ExtractTileRange(tileY);
 
-    for (int x = startX; x <= endX; ++x)
+    const size_t maxTiles = static_cast<size_t>(std::max(1, m_config.maxTiles));
+
+    ParseTiles(CoverTileRange(startX, endX, startY, endY, tileZ, tileZ,
+                              maxTiles),
+               tileZ);
+}
+
+void Geometry::ParseTiles(const std::vector<glm::ivec2>& tiles, int tileZ)
+{
+    if (tiles.empty())
+    {
+        throw std::invalid_argument("The region covers no tile");
+    }
+
+    std::set<std::pair<int, int>> selected;
+    for (const auto& tile : tiles)
+    {
+        selected.emplace(tile.x, tile.y);
+    }
+
+    const auto isSelected = [&selected](int x, int y) {
+        return selected.count({ x, y }) > 0;
+    };
+
+    for (const auto& tile : tiles)
+    {
+        Tile t(tile.x, tile.y, tileZ);
+
+        t.borders.set(Border::Left, !isSelected(tile.x - 1, tile.y));
+        t.borders.set(Border::Right, !isSelected(tile.x + 1, tile.y));
+        t.borders.set(Border::Top, !isSelected(tile.x, tile.y - 1));
+        t.borders.set(Border::Bottom, !isSelected(tile.x, tile.y + 1));
+
+        m_tiles.emplace_back(t);
+    }
+
+    m_profiler.AddCount("tiles", m_tiles.size());
+}
+
+void Geometry::DownloadData(const std::string& apiKey, bool terrain,
+                            double terrainExtrusionScale, bool buildings,
+                            bool roads)
+{
+    if (!m_downloader)
+    {
+        m_downloader = CreateDownloader(m_config);
+    }
+
+    OpenJournal();
+
+    // Keep every payload on disk as soon as it arrives
+    std::string tileCacheDir = m_config.tileCacheDir;
+    if (tileCacheDir.empty() && IsCheckpointed())
+    {
+        tileCacheDir = GetOutputName() + ".tiles";
+    }
+
+    if (!tileCacheDir.empty())
+    {
+        m_downloader = std::make_shared<DiskCachingDownloader>(
+            std::move(m_downloader), tileCacheDir);
+    }
+
+    LoadCachedMeshes();
+
+    // A resumed run tries the tiles that failed last time first, so that a
+    // source still down stops it before the rest of the region is fetched
+    std::vector<Tile> tiles = m_tiles;
+
+    if (m_journal)
     {
-        for (int y = startY; y <= endY; ++y)
+        const auto it = std::stable_partition(
+            tiles.begin(), tiles.end(), [this](const Tile& tile) {
+                return m_journal->GetState(tile) == TileJournal::State::Failed;
+            });
+
+        m_profiler.AddCount("retriedTiles",
+                            static_cast<size_t>(it - tiles.begin()));
+    }
+
+    for (const auto& tile : tiles)
+    {
+        const bool needsTerrain = terrain && IsTerrainNeeded(tile);
+        const bool needsTileData =
+            (buildings || roads) && !IsCached(tile, Features);
+
+        if (!needsTerrain && !needsTileData)
         {
-            Tile t(x, y, tileZ);
+            continue;
+        }
 
-            if (x == startX)
-            {
-                t.borders.set(Border::Left, true);
-            }
-            if (x == endX)
-            {
-                t.borders.set(Border::Right, true);
-            }
-            if (y == startY)
+        ScopedTrace trace(&m_profiler, tile.ToString(), "download");
+
+        for (int attempt = 0;; ++attempt)
+        {
+            try
             {
-                t.borders.set(Border::Top, true);
+                FetchTile(tile, apiKey, needsTerrain, terrainExtrusionScale,
+                          needsTileData);
+
+                if (m_journal)
+                {
+                    m_journal->Record(tile, TileJournal::State::Downloaded);
+                }
+
+                break;
             }
-            if (y == endY)
+            catch (const std::exception& e)
             {
-                t.borders.set(Border::Bottom, true);
-            }
+                // The payload may be what is broken, do not read it again
+                if (needsTerrain)
+                {
+                    m_downloader->Evict(
+                        GetTerrainURL(tile, apiKey, m_config.tileEndpoint));
+                }
+                if (needsTileData)
+                {
+                    m_downloader->Evict(
+                        GetVectorTileURL(tile, apiKey, m_config.tileEndpoint));
+                }
+
+                if (attempt < m_config.retries)
+                {
+                    m_profiler.AddCount("retries");
+                    continue;
+                }
+
+                if (m_journal)
+                {
+                    m_journal->Record(tile, TileJournal::State::Failed,
+                                      e.what());
+                }
 
-            m_tiles.emplace_back(t);
+                if (!m_config.skipFailedTiles)
+                {
+                    throw;
+                }
+
+                // Leave a hole in the region rather than losing the run
+                m_failedTiles.insert(tile);
+                m_heightData.erase(tile);
+                m_vectorTileData.erase(tile);
+                m_profiler.AddCount("failedTiles");
+
+                break;
+            }
         }
     }
+
+    if (m_failedTiles.size() == m_tiles.size())
+    {
+        throw std::logic_error("Failed to download any tile");
+    }
 }
 
-void Geometry::DownloadData(const std::string& apiKey, bool terrain,
-                            double terrainExtrusionScale, bool buildings,
-                            bool roads)
+void Geometry::FetchTile(const Tile& tile, const std::string& apiKey,
+                         bool terrain, double terrainExtrusionScale,
+                         bool tileData)
 {
-    for (auto& tile : m_tiles)
+    if (terrain)
     {
-        if (terrain)
+        std::unique_ptr<HeightData> textureData;
+
+        if (m_tileCache)
+        {
+            textureData =
+                m_tileCache->GetHeightData(tile, terrainExtrusionScale);
+        }
+
+        if (textureData)
+        {
+            m_profiler.AddCount("tileCacheHits");
+        }
+        else
         {
-            std::string url = GetTerrainURL(tile, apiKey);
-            auto textureData =
-                DownloadHeightmapTile(url, terrainExtrusionScale);
+            std::string url =
+                GetTerrainURL(tile, apiKey, m_config.tileEndpoint);
+            textureData = DownloadHeightmapTile(
+                *m_downloader, url, terrainExtrusionScale, &m_profiler);
 
             if (!textureData)
             {
                 throw std::logic_error(
-                    "Failed to download heightmap texture data");
+                    "Failed to download heightmap texture data of " +
+                    tile.ToString());
             }
 
-            m_heightData[tile] = std::move(textureData);
+            if (m_tileCache)
+            {
+                m_tileCache->PutHeightData(tile, terrainExtrusionScale,
+                                           *textureData);
+            }
+        }
+
+        m_heightData[tile] = std::move(textureData);
+    }
+
+    if (tileData)
+    {
+        std::shared_ptr<const TileData> data;
+
+        if (m_tileCache)
+        {
+            data = m_tileCache->GetTileData(tile);
         }
 
-        if (buildings || roads)
+        if (data)
         {
-            std::string url = GetVectorTileURL(tile, apiKey);
-            auto tileData = DownloadTile(url, tile);
+            m_profiler.AddCount("tileCacheHits");
+        }
+        else
+        {
+            std::string url =
+                GetVectorTileURL(tile, apiKey, m_config.tileEndpoint);
+            data = DownloadTile(*m_downloader, url, tile, &m_profiler);
+
+            if (!data)
+            {
+                throw std::logic_error(
+                    "Failed to download vector tile data of " +
+                    tile.ToString());
+            }
 
-            if (!tileData)
+            if (m_tileCache)
             {
-                throw std::logic_error("Failed to download vector tile data");
+                m_tileCache->PutTileData(tile, data);
             }
+        }
+
+        m_vectorTileData[tile] = std::move(data);
+    }
+}
+
+void Geometry::GenerateData(const CityGenerator& generator, bool terrain,
+                            double terrainExtrusionScale, bool buildings,
+                            bool roads)
+{
+    OpenJournal();
+    LoadCachedMeshes();
+
+    ScopedTimer timer(&m_profiler, "generate");
+
+    for (auto& tile : m_tiles)
+    {
+        if (terrain && IsTerrainNeeded(tile))
+        {
+            m_heightData[tile] =
+                generator.GenerateHeightData(tile, terrainExtrusionScale);
+        }
 
-            m_vectorTileData[tile] = std::move(tileData);
+        if ((buildings || roads) && !IsCached(tile, Features))
+        {
+            m_vectorTileData[tile] = generator.GenerateTileData(tile);
         }
     }
 }
 
 void Geometry::AdjustTerrainEdges()
 {
+    ScopedTimer timer(&m_profiler, "stitch");
+
     for (auto& tileData0 : m_heightData)
     {
         auto& tileHeight0 = tileData0.second;
@@ -138,53 +374,507 @@ void Geometry::AdjustTerrainEdges()
 
 void Geometry::BuildMeshes()
 {
-    glm::dvec2 offset;
-    const Tile origin = m_tiles[0];
+    {
+        ScopedTimer timer(&m_profiler, "build");
 
-    // Build meshes for each of the tiles
-    for (auto& tile : m_tiles)
+        glm::dvec2 offset;
+        const Tile origin = m_tiles[0];
+
+        // Build meshes for each of the tiles
+        for (auto& tile : m_tiles)
+        {
+            if (m_failedTiles.count(tile))
+            {
+                continue;
+            }
+
+            offset.x = (tile.x - origin.x) * 2.0;
+            offset.y = -(tile.y - origin.y) * 2.0;
+
+            ScopedTrace trace(&m_profiler, tile.ToString(), "build");
+
+            const auto& texData = m_heightData[tile];
+
+            if (m_config.terrain && !UseCachedMeshes(tile, Terrain, offset))
+            {
+                const size_t firstMesh = m_meshes.size();
+                BuildTerrainMesh(tile, offset, texData);
+                StoreMeshes(tile, Terrain, firstMesh);
+            }
+
+            if ((m_config.buildings || m_config.roads) &&
+                !UseCachedMeshes(tile, Features, offset))
+            {
+                const size_t firstMesh = m_meshes.size();
+                BuildVectorTileMesh(tile, offset, texData);
+                StoreMeshes(tile, Features, firstMesh);
+
+                // Release the tile geometry arena in one shot
+                m_vectorTileData.erase(tile);
+            }
+
+            if (m_journal)
+            {
+                m_journal->Record(tile, TileJournal::State::Built);
+            }
+        }
+    }
+
+    size_t numVertices = 0;
+    size_t numTriangles = 0;
+
+    for (const auto& mesh : m_meshes)
+    {
+        numVertices += mesh->positions.size();
+        numTriangles += mesh->indices.size() / 3;
+    }
+
+    m_profiler.AddCount("meshes", m_meshes.size());
+    m_profiler.AddCount("vertices", numVertices);
+    m_profiler.AddCount("triangles", numTriangles);
+}
+
+void Geometry::LoadCachedMeshes()
+{
+    if (!m_meshCache)
+    {
+        if (!m_config.meshCacheDir.empty())
+        {
+            m_meshCache = std::make_unique<MeshCache>(m_config.meshCacheDir);
+        }
+        else if (m_config.incremental || IsCheckpointed())
+        {
+            m_meshCache = std::make_unique<MeshCache>(GetOutputName() +
+                                                      ".cache");
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    ScopedTimer timer(&m_profiler, "meshCache");
+
+    const nlohmann::json options = ProgramOptions::ToJSON(m_config);
+    size_t numHits = 0;
+    size_t numMisses = 0;
+
+    for (const auto& tile : m_tiles)
+    {
+        auto& keys = m_meshCacheKeys[tile];
+
+        for (const MeshPart part : GetMeshParts())
+        {
+            keys[part] = GetMeshCacheKey(tile, part, options);
+
+            std::vector<std::unique_ptr<PolygonMesh>> meshes;
+            if (m_meshCache->Load(keys[part], meshes))
+            {
+                m_cachedMeshes[keys[part]] = std::move(meshes);
+                ++numHits;
+            }
+            else
+            {
+                ++numMisses;
+            }
+        }
+    }
+
+    m_profiler.AddCount("meshCacheHits", numHits);
+    m_profiler.AddCount("meshCacheMisses", numMisses);
+
+    if (m_journal)
+    {
+        size_t numResumed = 0;
+
+        for (const auto& tile : m_tiles)
+        {
+            if (m_journal->GetState(tile) == TileJournal::State::Built &&
+                IsBuilt(tile))
+            {
+                ++numResumed;
+            }
+        }
+
+        m_profiler.AddCount("resumedTiles", numResumed);
+    }
+}
+
+bool Geometry::UseCachedMeshes(const Tile& tile, MeshPart part,
+                               const glm::dvec2& offset)
+{
+    const auto keys = m_meshCacheKeys.find(tile);
+    if (keys == m_meshCacheKeys.end())
     {
-        offset.x = (tile.x - origin.x) * 2.0;
-        offset.y = -(tile.y - origin.y) * 2.0;
+        return false;
+    }
+
+    const auto cached = m_cachedMeshes.find(keys->second[part]);
+    if (cached == m_cachedMeshes.end())
+    {
+        return false;
+    }
+
+    for (auto& mesh : cached->second)
+    {
+        mesh->offset = offset;
+        m_meshes.push_back(std::move(mesh));
+    }
 
-        const auto& texData = m_heightData[tile];
+    m_cachedMeshes.erase(cached);
 
-        if (m_config.terrain)
+    return true;
+}
+
+void Geometry::StoreMeshes(const Tile& tile, MeshPart part, size_t firstMesh)
+{
+    if (!m_meshCache)
+    {
+        return;
+    }
+
+    // Next to a skipped tile the terrain was not stitched, yet the key only
+    // names the sources, which a remote source keeps when it comes back;
+    // leave the meshes out so that the next run stitches them
+    if (m_config.terrain)
+    {
+        for (const auto& neighbor : GetNeighbors(tile))
         {
-            BuildTerrainMesh(tile, offset, texData);
+            if (m_failedTiles.count(neighbor))
+            {
+                return;
+            }
         }
+    }
+
+    m_meshCache->Store(m_meshCacheKeys[tile][part], m_meshes, firstMesh,
+                       m_meshes.size());
+}
+
+bool Geometry::IsCached(const Tile& tile, MeshPart part) const
+{
+    const auto keys = m_meshCacheKeys.find(tile);
+
+    return keys != m_meshCacheKeys.end() &&
+           m_cachedMeshes.count(keys->second[part]) > 0;
+}
 
-        if (m_config.buildings || m_config.roads)
+bool Geometry::IsBuilt(const Tile& tile) const
+{
+    for (const MeshPart part : GetMeshParts())
+    {
+        if (!IsCached(tile, part))
         {
-            BuildVectorTileMesh(tile, offset, texData);
+            return false;
         }
     }
 
-    ExportToFile();
+    return true;
+}
+
+bool Geometry::IsTerrainNeeded(const Tile& tile) const
+{
+    if (!IsBuilt(tile))
+    {
+        return true;
+    }
+
+    // A cached tile still lends its edges to neighbors that are built
+    for (const auto& neighbor : GetNeighbors(tile))
+    {
+        if (!IsBuilt(neighbor))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<Geometry::MeshPart> Geometry::GetMeshParts() const
+{
+    std::vector<MeshPart> parts;
+
+    if (m_config.terrain)
+    {
+        parts.push_back(Terrain);
+    }
+
+    if (m_config.buildings || m_config.roads)
+    {
+        parts.push_back(Features);
+    }
+
+    return parts;
+}
+
+std::string Geometry::GetMeshCacheKey(const Tile& tile, MeshPart part,
+                                      const nlohmann::json& options) const
+{
+    nlohmann::json values = nlohmann::json::object();
+
+    for (const auto& name : GetPartOptions(part))
+    {
+        values[name] = options[name];
+    }
+
+    // Generated tiles are made from the generator options
+    if (m_config.synthetic)
+    {
+        for (const auto& option : options.items())
+        {
+            if (option.key().compare(0, 5, "city.") == 0)
+            {
+                values[option.key()] = option.value();
+            }
+        }
+    }
+
+    std::string key = tile.ToString() + " " + GetPartName(part) + " " +
+                      values.dump();
+
+    // The pedestal walls, and the buildings a clipped tile owns, follow the
+    // region borders
+    if ((part == Terrain && m_config.pedestal) ||
+        (part == Features && m_config.clipToTile))
+    {
+        key += " " + tile.borders.to_string();
+    }
+
+    if (part == Features)
+    {
+        key += " " + GetSourceVersion(
+                         GetVectorTileURL(tile, "", m_config.tileEndpoint));
+    }
+
+    // Both parts sample the terrain, whose edges are averaged with the
+    // neighbors in the region
+    if (m_config.terrain)
+    {
+        key += " " + GetSourceVersion(
+                         GetTerrainURL(tile, "", m_config.tileEndpoint));
+
+        for (const auto& neighbor : GetNeighbors(tile))
+        {
+            key += " " + neighbor.ToString() + " " +
+                   GetSourceVersion(
+                       GetTerrainURL(neighbor, "", m_config.tileEndpoint));
+        }
+    }
+
+    return key;
+}
+
+std::string Geometry::GetSourceVersion(const std::string& url) const
+{
+    return m_config.synthetic ? "synthetic" : m_downloader->GetVersion(url);
+}
+
+std::vector<Tile> Geometry::GetNeighbors(const Tile& tile) const
+{
+    std::vector<Tile> neighbors;
+
+    if (!tile.borders[Border::Left])
+    {
+        neighbors.emplace_back(tile.x - 1, tile.y, tile.z);
+    }
+    if (!tile.borders[Border::Right])
+    {
+        neighbors.emplace_back(tile.x + 1, tile.y, tile.z);
+    }
+    if (!tile.borders[Border::Top])
+    {
+        neighbors.emplace_back(tile.x, tile.y - 1, tile.z);
+    }
+    if (!tile.borders[Border::Bottom])
+    {
+        neighbors.emplace_back(tile.x, tile.y + 1, tile.z);
+    }
+
+    return neighbors;
+}
+
+bool Geometry::IsCheckpointed() const
+{
+    return m_config.checkpoint || m_config.resume;
+}
+
+void Geometry::OpenJournal()
+{
+    if (!IsCheckpointed() || m_journal)
+    {
+        return;
+    }
+
+    const std::string outFile = GetOutputName();
+
+    // A new run does not trust what an earlier one fetched, the data may
+    // have changed since
+    if (!m_config.resume)
+    {
+        std::error_code error;
+
+        if (m_config.tileCacheDir.empty())
+        {
+            std::filesystem::remove_all(outFile + ".tiles", error);
+        }
+
+        if (m_config.meshCacheDir.empty() && !m_config.incremental)
+        {
+            std::filesystem::remove_all(outFile + ".cache", error);
+        }
+    }
+
+    m_journal =
+        std::make_unique<TileJournal>(outFile + ".journal", m_config.resume);
+}
+
+std::string Geometry::GetOutputName() const
+{
+    if (!m_config.fileName.empty())
+    {
+        return m_config.fileName;
+    }
+
+    return std::to_string(m_tiles[0].x) + "." + std::to_string(m_tiles[0].y) +
+           "." + std::to_string(m_tiles[0].z);
+}
+
+void Geometry::UpdateManifest(const std::string& outFile) const
+{
+    const std::string fileName = outFile + ".manifest.json";
+    const nlohmann::json options = ProgramOptions::ToJSON(m_config);
+
+    nlohmann::json manifest;
+    manifest["options"] = nlohmann::json::object();
+    manifest["tiles"] = nlohmann::json::object();
+
+    for (const MeshPart part : GetMeshParts())
+    {
+        auto& values = manifest["options"][GetPartName(part)];
+
+        for (const auto& name : GetPartOptions(part))
+        {
+            values[name] = options[name];
+        }
+    }
+
+    std::set<std::string> entries;
+
+    for (const auto& tile : m_tiles)
+    {
+        if (m_failedTiles.count(tile))
+        {
+            continue;
+        }
+
+        auto& parts = manifest["tiles"][tile.ToString()];
+        const auto& keys = m_meshCacheKeys.at(tile);
+
+        for (const MeshPart part : GetMeshParts())
+        {
+            const std::string entry = MeshCache::GetEntryName(keys[part]);
+            parts[GetPartName(part)] = entry;
+            entries.insert(entry);
+        }
+    }
+
+    // Entries of the previous output that were replaced are dropped, unless
+    // the cache directory is shared with other outputs
+    std::ifstream previous(fileName);
+
+    if (previous.is_open() && m_config.meshCacheDir.empty())
+    {
+        const nlohmann::json old = nlohmann::json::parse(previous, nullptr,
+                                                         false);
+
+        if (old.is_object() && old.contains("tiles") &&
+            old["tiles"].is_object())
+        {
+            for (const auto& tile : old["tiles"])
+            {
+                for (const auto& entry : tile)
+                {
+                    if (entry.is_string() &&
+                        !entries.count(entry.get<std::string>()))
+                    {
+                        m_meshCache->Remove(entry.get<std::string>());
+                    }
+                }
+            }
+        }
+    }
+
+    previous.close();
+
+    std::ofstream file(fileName);
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open build manifest file");
+    }
+
+    file << manifest.dump(4) << "\n";
+}
+
+const std::vector<std::string>& Geometry::GetPartOptions(MeshPart part)
+{
+    static const std::vector<std::string> terrainOptions = {
+        "terrain", "terrainSubdivision", "terrainExtrusionScale", "pedestal",
+        "pedestalHeight", "normals", "normalWeighting", "simplify",
+        "simplifyRatio", "simplifyMaxError"
+    };
+
+    // Features are laid on the terrain when it is built
+    static const std::vector<std::string> featureOptions = {
+        "buildings", "roads", "buildingsHeight", "buildingsExtrusionScale",
+        "roadsHeight", "roadsExtrusionWidth", "clipToTile", "batchMeshes",
+        "featureIds", "normals", "normalWeighting", "simplify", "simplifyRatio",
+        "simplifyMaxError", "terrain", "terrainExtrusionScale"
+    };
+
+    return part == Terrain ? terrainOptions : featureOptions;
+}
+
+const char* Geometry::GetPartName(MeshPart part)
+{
+    return part == Terrain ? "terrain" : "features";
+}
+
+Profiler& Geometry::GetProfiler()
+{
+    return m_profiler;
+}
+
+const Profiler& Geometry::GetProfiler() const
+{
+    return m_profiler;
 }
 
 void Geometry::BuildTerrainMesh(const Tile& tile, const glm::dvec2& offset,
                                 const std::unique_ptr<HeightData>& texData)
 {
     // Extract a plane geometry for terrain mesh
-    auto mesh = std::unique_ptr<PolygonMesh>(new PolygonMesh);
-    BuildPlane(mesh->vertices, mesh->indices, 2, 2, m_config.terrainSubdivision,
+    auto mesh =
+        std::unique_ptr<PolygonMesh>(new PolygonMesh(m_config.normals));
+    BuildPlane(*mesh, 2, 2, m_config.terrainSubdivision,
                m_config.terrainSubdivision);
 
     // Build terrain mesh extrusion, with bilinear height sampling
-    for (auto& vertex : mesh->vertices)
+    for (auto& position : mesh->positions)
     {
-        const glm::dvec2 tilePosition =
-            glm::dvec2(vertex.position.x, vertex.position.y);
+        const glm::dvec2 tilePosition = glm::dvec2(position.x, position.y);
         const double extrusion = SampleElevation(tilePosition, texData);
 
         // Scale the height within the tile scale
-        vertex.position.z = extrusion * tile.invScale;
+        position.z = extrusion * tile.invScale;
     }
 
+    SimplifyMesh(*mesh, tile);
+
     if (m_config.normals)
     {
-        ComputeNormals(*mesh);
+        ComputeNormals(*mesh, m_config.normalWeighting, &m_profiler);
     }
 
     mesh->offset = offset;
@@ -199,19 +889,20 @@ void Geometry::BuildTerrainMesh(const Tile& tile, const glm::dvec2& offset,
 void Geometry::BuildPedestal(const Tile& tile, const glm::dvec2& offset,
                              const std::unique_ptr<HeightData>& texData)
 {
-    auto ground = std::unique_ptr<PolygonMesh>(new PolygonMesh);
-    auto wall = std::unique_ptr<PolygonMesh>(new PolygonMesh);
+    auto ground =
+        std::unique_ptr<PolygonMesh>(new PolygonMesh(m_config.normals));
+    auto wall = std::unique_ptr<PolygonMesh>(new PolygonMesh(m_config.normals));
 
-    BuildPlane(ground->vertices, ground->indices, 2, 2,
-               m_config.terrainSubdivision, m_config.terrainSubdivision, true);
+    BuildPlane(*ground, 2, 2, m_config.terrainSubdivision,
+               m_config.terrainSubdivision, true);
 
-    for (auto& vertex : ground->vertices)
+    for (auto& position : ground->positions)
     {
-        vertex.position.z = m_config.pedestalHeight * tile.invScale;
+        position.z = m_config.pedestalHeight * tile.invScale;
     }
 
-    BuildPedestalPlanes(tile, wall->vertices, wall->indices, texData,
-                        m_config.terrainSubdivision, m_config.pedestalHeight);
+    BuildPedestalPlanes(tile, *wall, texData, m_config.terrainSubdivision,
+                        m_config.pedestalHeight);
 
     ground->offset = offset;
     m_meshes.push_back(std::move(ground));
@@ -231,94 +922,201 @@ void Geometry::BuildVectorTileMesh(const Tile& tile, const glm::dvec2& offset,
     const static std::string keyHeight("height");
     const static std::string keyMinHeight("min_height");
 
+    const double scale = tile.invScale * m_config.buildingsExtrusionScale;
+
+    // Holds the part of each feature within the tile, the tile data being
+    // shared with other builds
+    TileData clipped;
+
     for (const auto& layer : data->layers)
     {
-        for (auto feature : layer.features)
+        const bool isBuildings = layer.name == "buildings";
+        const bool isRoads = layer.name == "roads";
+
+        if (texData && !isBuildings && !isRoads)
         {
-            if (texData && layer.name != "buildings" && layer.name != "roads")
-            {
-                continue;
-            }
+            continue;
+        }
 
-            auto itHeight = feature.props.numericProps.find(keyHeight);
-            auto itMinHeight = feature.props.numericProps.find(keyMinHeight);
-            const double scale =
-                tile.invScale * m_config.buildingsExtrusionScale;
-            double height = 0.0;
-            double minHeight = 0.0;
+        const double defaultHeight =
+            isBuildings ? m_config.buildingsHeight * tile.invScale : 0.0;
+        const std::string featureGroup =
+            std::to_string(tile.z) + "_" + std::to_string(tile.x) + "_" +
+            std::to_string(tile.y) + "_" + layer.name;
 
-            if (layer.name == "buildings")
-            {
-                height = m_config.buildingsHeight * tile.invScale;
-            }
+        // In batch mode every feature of the layer goes into a single mesh
+        std::unique_ptr<PolygonMesh> batch;
+        if (m_config.batchMeshes)
+        {
+            batch =
+                std::unique_ptr<PolygonMesh>(new PolygonMesh(m_config.normals));
+        }
+
+        for (size_t i = 0; i < layer.features.size(); ++i)
+        {
+            const auto& feature = layer.features[i];
+            const auto& numericProps = feature.props.numericProps;
+            auto itHeight = numericProps.find(keyHeight);
+            auto itMinHeight = numericProps.find(keyMinHeight);
+            double height = defaultHeight;
+            double minHeight = 0.0;
 
-            if (itHeight != feature.props.numericProps.end())
+            if (itHeight != numericProps.end())
             {
                 height = itHeight->second * scale;
             }
 
-            if (texData && layer.name != "roads" && height == 0.0)
+            if (texData && !isRoads && height == 0.0)
             {
                 continue;
             }
 
-            if (itMinHeight != feature.props.numericProps.end())
+            if (itMinHeight != numericProps.end())
             {
                 minHeight = itMinHeight->second * scale;
             }
 
-            auto mesh = std::unique_ptr<PolygonMesh>(new PolygonMesh);
+            // Tiles come with a buffer of features from their neighbors,
+            // which have to be cut away lest they are built twice
+            const TileData* polygonData = data.get();
+            const TileData* lineData = data.get();
+            Range polygons = feature.polygons;
+            Range lines = feature.lines;
+
+            if (m_config.clipToTile)
+            {
+                clipped.points.clear();
+                clipped.lines.clear();
+                clipped.polygons.clear();
+
+                // A building is left whole to the tile holding its anchor,
+                // so no wall or roof is cut where two tiles meet. The anchor
+                // is a vertex every tile finds alike, whereas a centroid
+                // depends on how much of the building each buffer holds
+                if (isBuildings)
+                {
+                    if (polygons.count > 0 &&
+                        !tile.OwnsOnGrid(GetAnchor(*data, polygons)))
+                    {
+                        continue;
+                    }
+                }
+                else
+                {
+                    polygons = ClipPolygonsToTile(*data, polygons, clipped);
+                    polygonData = &clipped;
+                }
+
+                lines = ClipLinesToTile(*data, lines, clipped);
+                lineData = &clipped;
+            }
+
+            std::unique_ptr<PolygonMesh> mesh;
+            if (!batch)
+            {
+                mesh = std::unique_ptr<PolygonMesh>(
+                    new PolygonMesh(m_config.normals));
+            }
+
+            auto& target = batch ? batch : mesh;
 
             if (m_config.buildings)
             {
-                BuildBuildings(feature.polygons, mesh, tile, texData, minHeight,
-                               height);
+                BuildBuildings(*polygonData, polygons, target, tile, texData,
+                               minHeight, height);
             }
 
             if (m_config.roads)
             {
-                BuildingRoads(feature.lines, mesh, tile, texData);
+                BuildRoads(*lineData, lines, *target, texData,
+                           m_config.roadsExtrusionWidth, m_config.roadsHeight,
+                           tile.invScale);
             }
 
-            // Add local mesh offset
-            mesh->offset = offset;
-            m_meshes.push_back(std::move(mesh));
+            if (m_config.featureIds)
+            {
+                target->featureIds.resize(target->positions.size(),
+                                          static_cast<unsigned int>(i));
+                target->featureGroup = featureGroup;
+            }
+
+            if (mesh)
+            {
+                AddVectorTileMesh(std::move(mesh), tile, offset);
+            }
+        }
+
+        if (batch)
+        {
+            AddVectorTileMesh(std::move(batch), tile, offset);
+        }
+    }
+}
+
+void Geometry::AddVectorTileMesh(std::unique_ptr<PolygonMesh> mesh,
+                                 const Tile& tile, const glm::dvec2& offset)
+{
+    if (mesh->positions.empty())
+    {
+        return;
+    }
+
+    if (m_config.roads && m_config.normals && m_config.terrain)
+    {
+        ComputeNormals(*mesh, m_config.normalWeighting, &m_profiler);
+    }
+
+    if (m_config.simplify)
+    {
+        SimplifyMesh(*mesh, tile);
+
+        if (m_config.normals)
+        {
+            // Welding joined the walls and roofs of buildings
+            SplitSharpEdges(*mesh);
+            ComputeNormals(*mesh, m_config.normalWeighting, &m_profiler);
         }
     }
+
+    // Add local mesh offset
+    mesh->offset = offset;
+    m_meshes.push_back(std::move(mesh));
 }
 
-void Geometry::BuildBuildings(const std::vector<Polygon>& polygons,
+void Geometry::BuildBuildings(const TileData& data, const Range& polygons,
                               std::unique_ptr<PolygonMesh>& mesh,
                               const Tile& tile,
                               const std::unique_ptr<HeightData>& texData,
                               double minHeight, double height)
 {
-    for (const auto& polygon : polygons)
+    for (size_t i = 0; i < polygons.count; ++i)
     {
+        const PolygonView polygon = data.GetPolygon(polygons.offset + i);
+
         double centroidHeight = 0.0;
         if (minHeight != height)
         {
             centroidHeight = BuildPolygonExtrusion(
-                polygon, minHeight, height, mesh->vertices, mesh->indices,
-                texData, tile.invScale);
+                polygon, minHeight, height, *mesh, texData, tile.invScale);
         }
 
-        BuildPolygon(polygon, height, mesh->vertices, mesh->indices,
-                     centroidHeight, tile.invScale);
+        BuildPolygon(polygon, height, *mesh, centroidHeight, tile.invScale);
     }
 }
 
-void Geometry::BuildingRoads(const std::vector<Line>& lines,
-                             std::unique_ptr<PolygonMesh>& mesh,
-                             const Tile& tile,
-                             const std::unique_ptr<HeightData>& texData) const
+void Geometry::BuildRoads(const TileData& data, const Range& lines,
+                          PolygonMesh& outMesh,
+                          const std::unique_ptr<HeightData>& elevation,
+                          double extrusionWidth, double height,
+                          double inverseTileScale)
 {
-    for (const auto& line : lines)
+    Line polygonLine;
+
+    for (size_t l = 0; l < lines.count; ++l)
     {
-        Polygon polygon;
-        double extrude = m_config.roadsExtrusionWidth * tile.invScale;
-        polygon.emplace_back();
-        Line& polygonLine = polygon.back();
+        const LineView line = data.GetLine(lines.offset + l);
+        double extrude = extrusionWidth * inverseTileScale;
+        polygonLine.clear();
 
         if (line.size() == 2)
         {
@@ -388,67 +1186,78 @@ void Geometry::BuildingRoads(const std::vector<Line>& lines,
         // Close the polygon
         polygonLine.push_back(polygonLine[0]);
 
-        size_t vertexOffset = mesh->vertices.size();
+        const Range ring{ 0, polygonLine.size() };
+        const PolygonView polygon(polygonLine.data(), &ring, 1);
 
-        if (m_config.roadsHeight > 0)
+        size_t vertexOffset = outMesh.positions.size();
+
+        if (height > 0)
         {
-            BuildPolygonExtrusion(
-                polygon, 0.0, m_config.roadsHeight * tile.invScale,
-                mesh->vertices, mesh->indices, nullptr, tile.invScale);
+            BuildPolygonExtrusion(polygon, 0.0, height * inverseTileScale,
+                                  outMesh, nullptr, inverseTileScale);
         }
 
-        BuildPolygon(polygon, m_config.roadsHeight * tile.invScale,
-                     mesh->vertices, mesh->indices, 0.0f, tile.invScale);
+        BuildPolygon(polygon, height * inverseTileScale, outMesh, 0.0f,
+                     inverseTileScale);
 
-        if (texData)
+        if (elevation)
         {
-            for (auto it = mesh->vertices.begin() + vertexOffset;
-                 it != mesh->vertices.end(); ++it)
+            for (auto it = outMesh.positions.begin() + vertexOffset;
+                 it != outMesh.positions.end(); ++it)
             {
-                it->position.z +=
-                    SampleElevation(glm::dvec2(it->position.x, it->position.y),
-                                    texData) *
-                    tile.invScale;
+                it->z += SampleElevation(glm::dvec2(it->x, it->y), elevation) *
+                         inverseTileScale;
             }
         }
     }
+}
 
-    if (m_config.normals && m_config.terrain)
+void Geometry::SimplifyMesh(PolygonMesh& mesh, const Tile& tile) const
+{
+    if (!m_config.simplify)
     {
-        ComputeNormals(*mesh);
+        return;
     }
+
+    // Error bound is given in meters, the quadric error is a squared distance
+    // in tile space
+    const double maxError = m_config.simplifyMaxError * tile.invScale;
+
+    MeshSimplifier simplifier(mesh);
+    simplifier.Simplify(m_config.simplifyRatio, maxError * maxError);
 }
 
 void Geometry::ExportToFile()
 {
-    std::string outFile;
-
-    if (!m_config.fileName.empty())
-    {
-        outFile = m_config.fileName;
-    }
-    else
-    {
-        outFile = std::to_string(m_tiles[0].x) + "." +
-                  std::to_string(m_tiles[0].y) + "." +
-                  std::to_string(m_tiles[0].z);
-    }
+    ScopedTimer timer(&m_profiler, "export");
 
+    const std::string outFile = GetOutputName();
     const std::string outputOBJ = outFile + ".obj";
 
     OBJExporter exporter;
     exporter.Save(outputOBJ, m_config.splitMesh, m_meshes, m_config.offsetX,
                   m_config.offsetY, m_config.append, m_config.normals);
+
+    if (m_config.incremental)
+    {
+        UpdateManifest(outFile);
+    }
 }
 
-void Geometry::BuildPlane(std::vector<PolygonVertex>& outVertices,
-                          std::vector<unsigned int>& outIndices, int width,
-                          int height, int nw, int nh, bool flip)
+void Geometry::ExportToStream(std::ostream& file)
 {
-    std::vector<glm::dvec4> vertices;
-    std::vector<int> indices;
+    ScopedTimer timer(&m_profiler, "export");
 
-    int indexOffset = 0;
+    OBJExporter exporter;
+    exporter.Write(file, m_tiles[0].ToString(), m_config.splitMesh, m_meshes,
+                   m_config.offsetX, m_config.offsetY, m_config.normals);
+}
+
+void Geometry::BuildPlane(PolygonMesh& outMesh, int width, int height, int nw,
+                          int nh, bool flip)
+{
+    auto& outIndices = outMesh.indices;
+    auto indexOffset = static_cast<unsigned int>(outMesh.positions.size());
 
     const double ow = static_cast<double>(width) / nw;
     const double oh = static_cast<double>(height) / nh;
@@ -471,10 +1280,10 @@ void Geometry::BuildPlane(std::vector<PolygonVertex>& outVertices,
             const glm::dvec3 v2(dw + ow, dh, 0.0);
             const glm::dvec3 v3(dw + ow, dh + oh, 0.0);
 
-            outVertices.push_back({ v0, normal });
-            outVertices.push_back({ v1, normal });
-            outVertices.push_back({ v2, normal });
-            outVertices.push_back({ v3, normal });
+            outMesh.AddVertex(v0, normal);
+            outMesh.AddVertex(v1, normal);
+            outMesh.AddVertex(v2, normal);
+            outMesh.AddVertex(v3, normal);
 
             if (!flip)
             {
@@ -500,14 +1309,14 @@ void Geometry::BuildPlane(std::vector<PolygonVertex>& outVertices,
     }
 }
 
-void Geometry::BuildPedestalPlanes(const Tile& tile,
-                                   std::vector<PolygonVertex>& outVertices,
-                                   std::vector<unsigned int>& outIndices,
+void Geometry::BuildPedestalPlanes(const Tile& tile, PolygonMesh& outMesh,
                                    const std::unique_ptr<HeightData>& elevation,
                                    int subDiv, double pedestalHeight)
 {
+    auto& outIndices = outMesh.indices;
     double offset = 1.0 / subDiv;
-    auto vertexDataOffset = static_cast<unsigned int>(outVertices.size());
+    auto vertexDataOffset =
+        static_cast<unsigned int>(outMesh.positions.size());
 
     for (size_t i = 0; i < tile.borders.size(); ++i)
     {
@@ -556,13 +1365,13 @@ void Geometry::BuildPedestalPlanes(const Tile& tile,
             double h1 = SampleElevation(glm::dvec2(v1.x, v1.y), elevation);
 
             v0.z = h0 * tile.invScale;
-            outVertices.push_back({ v0, normalVector });
+            outMesh.AddVertex(v0, normalVector);
             v1.z = h1 * tile.invScale;
-            outVertices.push_back({ v1, normalVector });
+            outMesh.AddVertex(v1, normalVector);
             v0.z = pedestalHeight * tile.invScale;
-            outVertices.push_back({ v0, normalVector });
+            outMesh.AddVertex(v0, normalVector);
             v1.z = pedestalHeight * tile.invScale;
-            outVertices.push_back({ v1, normalVector });
+            outMesh.AddVertex(v1, normalVector);
 
             if (i == Border::Right || i == Border::Bottom)
             {
@@ -589,12 +1398,13 @@ void Geometry::BuildPedestalPlanes(const Tile& tile,
 }
 
 double Geometry::BuildPolygonExtrusion(
-    const Polygon& polygon, double minHeight, double height,
-    std::vector<PolygonVertex>& outVertices,
-    std::vector<unsigned int>& outIndices,
-    const std::unique_ptr<HeightData>& elevation, double inverseTileScale)
+    const PolygonView& polygon, double minHeight, double height,
+    PolygonMesh& outMesh, const std::unique_ptr<HeightData>& elevation,
+    double inverseTileScale)
 {
-    auto vertexDataOffset = static_cast<unsigned int>(outVertices.size());
+    auto& outIndices = outMesh.indices;
+    auto vertexDataOffset =
+        static_cast<unsigned int>(outMesh.positions.size());
     const glm::dvec3 upVector(0.0, 0.0, 1.0);
     double minZ = 0.0;
     double cz = 0.0;
@@ -606,7 +1416,7 @@ double Geometry::BuildPolygonExtrusion(
         cz = SampleElevation(GetCentroid(polygon), elevation);
         minZ = std::numeric_limits<float>::max();
 
-        for (auto& line : polygon)
+        for (const auto& line : polygon)
         {
             for (const auto& point : line)
             {
@@ -618,13 +1428,10 @@ double Geometry::BuildPolygonExtrusion(
         }
     }
 
-    for (auto& line : polygon)
+    for (const auto& line : polygon)
     {
         const size_t lineSize = line.size();
 
-        outVertices.reserve(outVertices.size() + lineSize * 4);
-        outIndices.reserve(outIndices.size() + lineSize * 6);
-
         for (size_t i = 0; i < lineSize - 1; i++)
         {
             glm::dvec3 a(line[i]);
@@ -639,13 +1446,13 @@ double Geometry::BuildPolygonExtrusion(
             normalVector = glm::normalize(normalVector);
 
             a.z = height + cz * inverseTileScale;
-            outVertices.push_back({ a, normalVector });
+            outMesh.AddVertex(a, normalVector);
             b.z = height + cz * inverseTileScale;
-            outVertices.push_back({ b, normalVector });
+            outMesh.AddVertex(b, normalVector);
             a.z = minHeight + minZ * inverseTileScale;
-            outVertices.push_back({ a, normalVector });
+            outMesh.AddVertex(a, normalVector);
             b.z = minHeight + minZ * inverseTileScale;
-            outVertices.push_back({ b, normalVector });
+            outMesh.AddVertex(b, normalVector);
 
             outIndices.push_back(vertexDataOffset + 0);
             outIndices.push_back(vertexDataOffset + 1);
@@ -661,52 +1468,31 @@ double Geometry::BuildPolygonExtrusion(
     return cz;
 }
 
-void Geometry::BuildPolygon(const Polygon& polygon, double height,
-                            std::vector<PolygonVertex>& outVertices,
-                            std::vector<unsigned int>& outIndices,
-                            double centroidHeight, double inverseTileScale)
+void Geometry::BuildPolygon(const PolygonView& polygon, double height,
+                            PolygonMesh& outMesh, double centroidHeight,
+                            double inverseTileScale)
 {
-    std::vector<std::vector<std::array<double, 2>>> poly;
-    for (auto& line : polygon)
-    {
-        std::vector<std::array<double, 2>> points;
-        points.reserve(line.size());
+    auto& outIndices = outMesh.indices;
 
-        for (const auto& point : line)
-        {
-            points.push_back({ point.x, point.y });
-        }
+    // Reuse the triangulator per thread to keep its buffers between calls
+    thread_local mapbox::detail::Earcut<unsigned int> earcut;
+    earcut(polygon);
 
-        poly.push_back(points);
-    }
-    mapbox::detail::Earcut<unsigned int> earcut;
-    earcut(poly);
-
-    const auto vertexDataOffset = static_cast<unsigned int>(outVertices.size());
+    const auto vertexDataOffset =
+        static_cast<unsigned int>(outMesh.positions.size());
 
     if (earcut.indices.empty())
     {
         return;
     }
 
-    if (vertexDataOffset == 0)
+    for (auto i : earcut.indices)
     {
-        outIndices = std::move(earcut.indices);
-    }
-    else
-    {
-        outIndices.reserve(outIndices.size() + earcut.indices.size());
-
-        for (auto i : earcut.indices)
-        {
-            outIndices.push_back(vertexDataOffset + i);
-        }
+        outIndices.push_back(vertexDataOffset + i);
     }
 
     static glm::dvec3 normal(0.0, 0.0, 1.0);
 
-    outVertices.reserve(outVertices.size() + earcut.vertices);
-
     centroidHeight *= inverseTileScale;
 
     for (const auto& line : polygon)
@@ -716,7 +1502,7 @@ void Geometry::BuildPolygon(const Polygon& polygon, double height,
             const glm::dvec2 position(vertex[0], vertex[1]);
             const glm::dvec3 coord(position.x, position.y,
                                    height + centroidHeight);
-            outVertices.push_back({ coord, normal });
+            outMesh.AddVertex(coord, normal);
         }
     }
 }
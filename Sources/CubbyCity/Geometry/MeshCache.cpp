@@ -0,0 +1,230 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Geometry/MeshCache.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace CubbyCity
+{
+namespace
+{
+constexpr char MAGIC[8] = { 'C', 'C', 'M', 'E', 'S', 'H', '0', '2' };
+
+std::uint64_t HashKey(const std::string& key)
+{
+    // 64-bit FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (const char c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+template <typename T>
+void WriteValue(std::ostream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(std::istream& file, T& value)
+{
+    return static_cast<bool>(
+        file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+void WriteArray(std::ostream& file, const std::vector<T>& values)
+{
+    WriteValue(file, static_cast<std::uint64_t>(values.size()));
+    file.write(reinterpret_cast<const char*>(values.data()),
+               static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+bool ReadArray(std::istream& file, std::vector<T>& values,
+               std::uint64_t remaining)
+{
+    std::uint64_t size;
+
+    // Reject sizes the file cannot hold before allocating them
+    if (!ReadValue(file, size) || size > remaining / sizeof(T))
+    {
+        return false;
+    }
+
+    values.resize(static_cast<size_t>(size));
+
+    return static_cast<bool>(
+        file.read(reinterpret_cast<char*>(values.data()),
+                  static_cast<std::streamsize>(size * sizeof(T))));
+}
+}  // namespace
+
+MeshCache::MeshCache(std::string directory) : m_directory(std::move(directory))
+{
+    // Do nothing
+}
+
+bool MeshCache::Load(const std::string& key,
+                     std::vector<std::unique_ptr<PolygonMesh>>& meshes) const
+{
+    const std::string path = GetFilePath(key);
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::error_code error;
+    const std::uint64_t fileSize = std::filesystem::file_size(path, error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    char magic[sizeof(MAGIC)];
+    std::uint32_t vectorSize;
+
+    if (!file.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), MAGIC) ||
+        !ReadValue(file, vectorSize) || vectorSize != sizeof(MeshVector))
+    {
+        return false;
+    }
+
+    std::vector<char> keyBytes;
+    if (!ReadArray(file, keyBytes, fileSize) ||
+        std::string(keyBytes.begin(), keyBytes.end()) != key)
+    {
+        return false;
+    }
+
+    std::uint64_t numMeshes;
+    if (!ReadValue(file, numMeshes) || numMeshes > fileSize)
+    {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<PolygonMesh>> loaded;
+    loaded.reserve(static_cast<size_t>(numMeshes));
+    std::vector<char> featureGroup;
+
+    for (std::uint64_t i = 0; i < numMeshes; ++i)
+    {
+        std::uint8_t hasNormals;
+        if (!ReadValue(file, hasNormals))
+        {
+            return false;
+        }
+
+        auto mesh = std::make_unique<PolygonMesh>(hasNormals != 0);
+
+        if (!ReadArray(file, mesh->indices, fileSize) ||
+            !ReadArray(file, mesh->positions, fileSize) ||
+            !ReadArray(file, mesh->normals, fileSize) ||
+            !ReadArray(file, mesh->featureIds, fileSize) ||
+            !ReadArray(file, featureGroup, fileSize))
+        {
+            return false;
+        }
+
+        mesh->featureGroup.assign(featureGroup.begin(), featureGroup.end());
+
+        loaded.push_back(std::move(mesh));
+    }
+
+    for (auto& mesh : loaded)
+    {
+        meshes.push_back(std::move(mesh));
+    }
+
+    return true;
+}
+
+void MeshCache::Store(const std::string& key,
+                      const std::vector<std::unique_ptr<PolygonMesh>>& meshes,
+                      size_t begin, size_t end) const
+{
+    const std::filesystem::path path = GetFilePath(key);
+    std::filesystem::create_directories(path.parent_path());
+
+    // A unique name per writer, so concurrent runs never share a file
+    std::random_device random;
+    const std::filesystem::path tempPath =
+        path.string() + "." + std::to_string(random()) + ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary);
+
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open mesh cache file");
+        }
+
+        file.write(MAGIC, sizeof(MAGIC));
+        WriteValue(file, static_cast<std::uint32_t>(sizeof(MeshVector)));
+        WriteArray(file, std::vector<char>(key.begin(), key.end()));
+        WriteValue(file, static_cast<std::uint64_t>(end - begin));
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const PolygonMesh& mesh = *meshes[i];
+
+            WriteValue(file, static_cast<std::uint8_t>(mesh.hasNormals));
+            WriteArray(file, mesh.indices);
+            WriteArray(file, mesh.positions);
+            WriteArray(file, mesh.normals);
+            WriteArray(file, mesh.featureIds);
+            WriteArray(file, std::vector<char>(mesh.featureGroup.begin(),
+                                               mesh.featureGroup.end()));
+        }
+
+        if (!file.good())
+        {
+            file.close();
+            std::filesystem::remove(tempPath);
+            throw std::runtime_error("Failed to write mesh cache file");
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+void MeshCache::Remove(const std::string& entryName) const
+{
+    std::error_code error;
+    std::filesystem::remove(m_directory + "/" + entryName, error);
+}
+
+std::string MeshCache::GetFilePath(const std::string& key) const
+{
+    return m_directory + "/" + GetEntryName(key);
+}
+
+std::string MeshCache::GetEntryName(const std::string& key)
+{
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx",
+                  static_cast<unsigned long long>(HashKey(key)));
+
+    // Fan out over 256 directories to keep each of them small
+    return std::string(name, 2) + "/" + name + ".mesh";
+}
+}  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,520 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Geometry/MeshSimplifier.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace CubbyCity
+{
+// Weight of the planes that keep open boundaries (building bottoms, road ends)
+// from shrinking during decimation
+constexpr static double BOUNDARY_WEIGHT = 1000.0;
+
+// Grid used to weld vertices whose positions differ only by rounding
+constexpr static double INV_WELD_EPSILON = 1e9;
+
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(
+    const Quadric& rhs)
+{
+    for (size_t i = 0; i < m.size(); ++i)
+    {
+        m[i] += rhs.m[i];
+    }
+
+    return *this;
+}
+
+void MeshSimplifier::Quadric::AddPlane(const glm::dvec3& n, double d,
+                                       double weight)
+{
+    m[0] += weight * n.x * n.x;
+    m[1] += weight * n.x * n.y;
+    m[2] += weight * n.x * n.z;
+    m[3] += weight * n.x * d;
+    m[4] += weight * n.y * n.y;
+    m[5] += weight * n.y * n.z;
+    m[6] += weight * n.y * d;
+    m[7] += weight * n.z * n.z;
+    m[8] += weight * n.z * d;
+    m[9] += weight * d * d;
+}
+
+double MeshSimplifier::Quadric::Evaluate(const glm::dvec3& v) const
+{
+    const double error = m[0] * v.x * v.x + 2.0 * m[1] * v.x * v.y +
+                         2.0 * m[2] * v.x * v.z + 2.0 * m[3] * v.x +
+                         m[4] * v.y * v.y + 2.0 * m[5] * v.y * v.z +
+                         2.0 * m[6] * v.y + m[7] * v.z * v.z +
+                         2.0 * m[8] * v.z + m[9];
+
+    return std::max(error, 0.0);
+}
+
+bool MeshSimplifier::Quadric::Optimize(glm::dvec3& out) const
+{
+    // Solve the 3x3 system by Cramer's rule
+    const double det = m[0] * (m[4] * m[7] - m[5] * m[5]) -
+                       m[1] * (m[1] * m[7] - m[5] * m[2]) +
+                       m[2] * (m[1] * m[5] - m[4] * m[2]);
+
+    if (std::abs(det) < 1e-12)
+    {
+        return false;
+    }
+
+    const double invDet = 1.0 / det;
+    const double bx = -m[3];
+    const double by = -m[6];
+    const double bz = -m[8];
+
+    out.x = invDet * (bx * (m[4] * m[7] - m[5] * m[5]) -
+                      m[1] * (by * m[7] - m[5] * bz) +
+                      m[2] * (by * m[5] - m[4] * bz));
+    out.y = invDet * (m[0] * (by * m[7] - bz * m[5]) -
+                      bx * (m[1] * m[7] - m[5] * m[2]) +
+                      m[2] * (m[1] * bz - by * m[2]));
+    out.z = invDet * (m[0] * (m[4] * bz - m[5] * by) -
+                      m[1] * (m[1] * bz - by * m[2]) +
+                      bx * (m[1] * m[5] - m[4] * m[2]));
+
+    return true;
+}
+
+bool MeshSimplifier::Collapse::operator<(const Collapse& rhs) const
+{
+    // Reversed so that std::push_heap yields a min-heap on cost
+    return cost > rhs.cost;
+}
+
+MeshSimplifier::MeshSimplifier(PolygonMesh& mesh) : m_mesh(mesh)
+{
+    // Do nothing
+}
+
+void MeshSimplifier::Simplify(double targetRatio, double maxError)
+{
+    if (m_mesh.indices.size() < 3)
+    {
+        return;
+    }
+
+    Weld();
+    ComputeQuadrics();
+
+    const auto targetTriangles = static_cast<size_t>(
+        std::max(targetRatio, 0.0) * static_cast<double>(m_numTriangles));
+
+    // Seed the heap with every unique edge
+    std::vector<std::pair<unsigned int, unsigned int>> edges;
+    edges.reserve(m_triangles.size() * 3);
+
+    for (const auto& triangle : m_triangles)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            unsigned int a = triangle[i];
+            unsigned int b = triangle[(i + 1) % 3];
+            edges.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    for (const auto& edge : edges)
+    {
+        PushCollapse(edge.first, edge.second);
+    }
+
+    while (m_numTriangles > targetTriangles && !m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        const Collapse collapse = m_heap.back();
+        m_heap.pop_back();
+
+        // Skip collapses invalidated by earlier ones
+        if (m_removedVertices[collapse.keep] ||
+            m_removedVertices[collapse.remove] ||
+            m_stamps[collapse.keep] != collapse.keepStamp ||
+            m_stamps[collapse.remove] != collapse.removeStamp)
+        {
+            continue;
+        }
+
+        if (maxError > 0.0 && collapse.cost > maxError)
+        {
+            break;
+        }
+
+        if (Flips(collapse.keep, collapse.remove, collapse.target) ||
+            Flips(collapse.remove, collapse.keep, collapse.target))
+        {
+            continue;
+        }
+
+        ApplyCollapse(collapse);
+    }
+
+    WriteBack();
+}
+
+void MeshSimplifier::Weld()
+{
+    const auto& positions = m_mesh.positions;
+    const bool hasFeatureIds = !m_mesh.featureIds.empty();
+
+    // Vertices of different features stay apart, so that every triangle
+    // keeps the id of its own feature after collapses
+    std::vector<std::array<long long, 4>> keys(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const glm::dvec3 p(positions[i]);
+        keys[i] = { std::llround(p.x * INV_WELD_EPSILON),
+                    std::llround(p.y * INV_WELD_EPSILON),
+                    std::llround(p.z * INV_WELD_EPSILON),
+                    hasFeatureIds ? m_mesh.featureIds[i] : 0 };
+    }
+
+    std::vector<unsigned int> order(positions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        return keys[a] < keys[b];
+    });
+
+    std::vector<unsigned int> remap(positions.size());
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (i == 0 || keys[order[i]] != keys[order[i - 1]])
+        {
+            m_positions.emplace_back(positions[order[i]]);
+
+            if (hasFeatureIds)
+            {
+                m_featureIds.push_back(m_mesh.featureIds[order[i]]);
+            }
+        }
+
+        remap[order[i]] = static_cast<unsigned int>(m_positions.size() - 1);
+    }
+
+    m_vertexTriangles.resize(m_positions.size());
+    m_triangles.reserve(m_mesh.indices.size() / 3);
+
+    for (size_t i = 0; i + 2 < m_mesh.indices.size(); i += 3)
+    {
+        const std::array<unsigned int, 3> triangle = {
+            remap[m_mesh.indices[i + 0]], remap[m_mesh.indices[i + 1]],
+            remap[m_mesh.indices[i + 2]]
+        };
+
+        // Drop triangles that collapsed while welding
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] ||
+            triangle[2] == triangle[0])
+        {
+            continue;
+        }
+
+        const auto index = static_cast<unsigned int>(m_triangles.size());
+        for (unsigned int v : triangle)
+        {
+            m_vertexTriangles[v].push_back(index);
+        }
+
+        m_triangles.push_back(triangle);
+    }
+
+    m_numTriangles = m_triangles.size();
+    m_removedTriangles.assign(m_triangles.size(), false);
+    m_removedVertices.assign(m_positions.size(), false);
+    m_stamps.assign(m_positions.size(), 0);
+    m_locked.resize(m_positions.size());
+
+    for (size_t i = 0; i < m_positions.size(); ++i)
+    {
+        const glm::dvec3& p = m_positions[i];
+        m_locked[i] = std::abs(std::abs(p.x) - 1.0) < EPSILON ||
+                      std::abs(std::abs(p.y) - 1.0) < EPSILON;
+    }
+}
+
+void MeshSimplifier::ComputeQuadrics()
+{
+    m_quadrics.assign(m_positions.size(), Quadric{});
+
+    std::vector<std::pair<unsigned int, unsigned int>> edges;
+    std::vector<unsigned int> edgeTriangles;
+
+    for (size_t t = 0; t < m_triangles.size(); ++t)
+    {
+        const auto& triangle = m_triangles[t];
+        const glm::dvec3& p0 = m_positions[triangle[0]];
+        const glm::dvec3& p1 = m_positions[triangle[1]];
+        const glm::dvec3& p2 = m_positions[triangle[2]];
+
+        const glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+        const double length = glm::length(n);
+
+        if (length < std::numeric_limits<double>::epsilon())
+        {
+            continue;
+        }
+
+        const glm::dvec3 normal = n / length;
+        const double d = -glm::dot(normal, p0);
+
+        for (unsigned int v : triangle)
+        {
+            m_quadrics[v].AddPlane(normal, d, 1.0);
+        }
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            unsigned int a = triangle[i];
+            unsigned int b = triangle[(i + 1) % 3];
+            edges.emplace_back(std::min(a, b), std::max(a, b));
+            edgeTriangles.push_back(static_cast<unsigned int>(t));
+        }
+    }
+
+    // Add constraint planes perpendicular to open boundary edges
+    std::vector<size_t> order(edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return edges[a] < edges[b]; });
+
+    for (size_t i = 0; i < order.size();)
+    {
+        size_t j = i + 1;
+        while (j < order.size() && edges[order[j]] == edges[order[i]])
+        {
+            ++j;
+        }
+
+        if (j - i == 1)
+        {
+            const auto& edge = edges[order[i]];
+            const auto& triangle = m_triangles[edgeTriangles[order[i]]];
+            const glm::dvec3& a = m_positions[edge.first];
+            const glm::dvec3& b = m_positions[edge.second];
+            const glm::dvec3 faceNormal =
+                glm::cross(m_positions[triangle[1]] - m_positions[triangle[0]],
+                           m_positions[triangle[2]] - m_positions[triangle[0]]);
+            const glm::dvec3 n = glm::cross(b - a, faceNormal);
+            const double length = glm::length(n);
+
+            if (length > std::numeric_limits<double>::epsilon())
+            {
+                const glm::dvec3 normal = n / length;
+                const double d = -glm::dot(normal, a);
+
+                m_quadrics[edge.first].AddPlane(normal, d, BOUNDARY_WEIGHT);
+                m_quadrics[edge.second].AddPlane(normal, d, BOUNDARY_WEIGHT);
+            }
+        }
+
+        i = j;
+    }
+}
+
+void MeshSimplifier::PushCollapse(unsigned int v0, unsigned int v1)
+{
+    if (m_locked[v0] && m_locked[v1])
+    {
+        return;
+    }
+
+    // A locked vertex always survives at its own position
+    if (m_locked[v1])
+    {
+        std::swap(v0, v1);
+    }
+
+    Quadric quadric = m_quadrics[v0];
+    quadric += m_quadrics[v1];
+
+    glm::dvec3 target = m_positions[v0];
+    double cost = quadric.Evaluate(target);
+
+    if (!m_locked[v0])
+    {
+        glm::dvec3 optimal;
+        if (quadric.Optimize(optimal))
+        {
+            target = optimal;
+            cost = quadric.Evaluate(optimal);
+        }
+        else
+        {
+            const glm::dvec3 candidates[] = {
+                m_positions[v1], (m_positions[v0] + m_positions[v1]) * 0.5
+            };
+
+            for (const auto& candidate : candidates)
+            {
+                const double candidateCost = quadric.Evaluate(candidate);
+                if (candidateCost < cost)
+                {
+                    target = candidate;
+                    cost = candidateCost;
+                }
+            }
+        }
+    }
+
+    m_heap.push_back({ cost, v0, v1, m_stamps[v0], m_stamps[v1], target });
+    std::push_heap(m_heap.begin(), m_heap.end());
+}
+
+bool MeshSimplifier::Flips(unsigned int moved, unsigned int other,
+                           const glm::dvec3& target) const
+{
+    for (unsigned int t : m_vertexTriangles[moved])
+    {
+        if (m_removedTriangles[t])
+        {
+            continue;
+        }
+
+        const auto& triangle = m_triangles[t];
+        if (triangle[0] == other || triangle[1] == other ||
+            triangle[2] == other)
+        {
+            continue;
+        }
+
+        glm::dvec3 p[3];
+        glm::dvec3 q[3];
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            p[i] = m_positions[triangle[i]];
+            q[i] = triangle[i] == moved ? target : p[i];
+        }
+
+        const glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        const glm::dvec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+
+        if (glm::dot(before, after) <= 0.0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MeshSimplifier::ApplyCollapse(const Collapse& collapse)
+{
+    const unsigned int keep = collapse.keep;
+    const unsigned int remove = collapse.remove;
+
+    m_positions[keep] = collapse.target;
+    m_quadrics[keep] += m_quadrics[remove];
+    m_removedVertices[remove] = true;
+
+    for (unsigned int t : m_vertexTriangles[remove])
+    {
+        if (m_removedTriangles[t])
+        {
+            continue;
+        }
+
+        auto& triangle = m_triangles[t];
+        if (triangle[0] == keep || triangle[1] == keep || triangle[2] == keep)
+        {
+            m_removedTriangles[t] = true;
+            --m_numTriangles;
+            continue;
+        }
+
+        for (unsigned int& v : triangle)
+        {
+            if (v == remove)
+            {
+                v = keep;
+            }
+        }
+
+        m_vertexTriangles[keep].push_back(t);
+    }
+
+    m_vertexTriangles[remove].clear();
+
+    auto& triangles = m_vertexTriangles[keep];
+    triangles.erase(std::remove_if(triangles.begin(), triangles.end(),
+                                   [&](unsigned int t) {
+                                       return m_removedTriangles[t];
+                                   }),
+                    triangles.end());
+
+    ++m_stamps[keep];
+    ++m_stamps[remove];
+
+    // Re-evaluate every edge around the surviving vertex
+    std::vector<unsigned int> neighbors;
+    for (unsigned int t : triangles)
+    {
+        for (unsigned int v : m_triangles[t])
+        {
+            if (v != keep)
+            {
+                neighbors.push_back(v);
+            }
+        }
+    }
+
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+
+    for (unsigned int v : neighbors)
+    {
+        PushCollapse(keep, v);
+    }
+}
+
+void MeshSimplifier::WriteBack()
+{
+    const unsigned int invalid = std::numeric_limits<unsigned int>::max();
+    std::vector<unsigned int> remap(m_positions.size(), invalid);
+
+    m_mesh.positions.clear();
+    m_mesh.normals.clear();
+    m_mesh.featureIds.clear();
+    m_mesh.indices.clear();
+    m_mesh.indices.reserve(m_numTriangles * 3);
+
+    for (size_t t = 0; t < m_triangles.size(); ++t)
+    {
+        if (m_removedTriangles[t])
+        {
+            continue;
+        }
+
+        for (unsigned int v : m_triangles[t])
+        {
+            if (remap[v] == invalid)
+            {
+                remap[v] = static_cast<unsigned int>(m_mesh.positions.size());
+                m_mesh.positions.emplace_back(m_positions[v]);
+
+                if (!m_featureIds.empty())
+                {
+                    m_mesh.featureIds.push_back(m_featureIds[v]);
+                }
+            }
+
+            m_mesh.indices.push_back(remap[v]);
+        }
+    }
+}
+}  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,107 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Geometry/TileCache.hpp>
+
+#include <string>
+#include <utility>
+
+namespace CubbyCity
+{
+namespace
+{
+std::string GetHeightDataKey(const Tile& tile, double extrusionScale)
+{
+    return tile.ToString() + "@" + std::to_string(extrusionScale);
+}
+
+size_t GetSizeInBytes(const HeightData& data)
+{
+    return static_cast<size_t>(data.width) *
+           (sizeof(std::vector<double>) + data.height * sizeof(double));
+}
+
+//! Returns the bytes \p s holds on the heap, none when its characters fit
+//! in the string object itself.
+size_t GetHeapSizeInBytes(const std::string& s)
+{
+    return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+}
+
+size_t GetSizeInBytes(const TileData& data)
+{
+    // A std::map node carries its color and three links besides the value
+    constexpr size_t mapNodeSize =
+        4 * sizeof(void*) + sizeof(std::pair<const std::string, double>);
+
+    size_t size = data.points.size() * sizeof(Point) +
+                  (data.lines.size() + data.polygons.size()) * sizeof(Range);
+
+    for (const auto& layer : data.layers)
+    {
+        size += sizeof(Layer) + GetHeapSizeInBytes(layer.name) +
+                layer.features.size() * sizeof(Feature);
+
+        for (const auto& feature : layer.features)
+        {
+            for (const auto& prop : feature.props.numericProps)
+            {
+                size += mapNodeSize + GetHeapSizeInBytes(prop.first);
+            }
+        }
+    }
+
+    return size;
+}
+}  // namespace
+
+TileCache::TileCache(size_t capacityBytes)
+    : m_heightData(capacityBytes / 2), m_tileData(capacityBytes / 2)
+{
+    // Do nothing
+}
+
+std::unique_ptr<HeightData> TileCache::GetHeightData(const Tile& tile,
+                                                     double extrusionScale)
+{
+    std::shared_ptr<const HeightData> data;
+
+    if (!m_heightData.Get(GetHeightDataKey(tile, extrusionScale), data))
+    {
+        return nullptr;
+    }
+
+    return std::make_unique<HeightData>(*data);
+}
+
+void TileCache::PutHeightData(const Tile& tile, double extrusionScale,
+                              const HeightData& data)
+{
+    m_heightData.Put(GetHeightDataKey(tile, extrusionScale),
+                     std::make_shared<const HeightData>(data),
+                     GetSizeInBytes(data));
+}
+
+std::shared_ptr<const TileData> TileCache::GetTileData(const Tile& tile)
+{
+    std::shared_ptr<const TileData> data;
+    m_tileData.Get(tile.ToString(), data);
+
+    return data;
+}
+
+void TileCache::PutTileData(const Tile& tile,
+                            std::shared_ptr<const TileData> data)
+{
+    const size_t size = GetSizeInBytes(*data);
+    m_tileData.Put(tile.ToString(), std::move(data), size);
+}
+
+size_t TileCache::GetSize() const
+{
+    return m_heightData.GetSize() + m_tileData.GetSize();
+}
+}  // namespace CubbyCity
\ No newline at end of file
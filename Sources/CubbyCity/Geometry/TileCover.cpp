@@ -0,0 +1,478 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/CommonUtils.hpp>
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Geometry/TileCover.hpp>
+#include <CubbyCity/Geometry/TileUtils.hpp>
+
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace CubbyCity
+{
+namespace
+{
+using TileSet = std::set<std::pair<int, int>>;
+
+double ParseDegrees(const std::string& value)
+{
+    size_t end = 0;
+    double degrees = 0.0;
+
+    try
+    {
+        degrees = std::stod(value, &end);
+    }
+    catch (const std::exception&)
+    {
+        end = 0;
+    }
+
+    if (end == 0 || end != value.size() || !std::isfinite(degrees))
+    {
+        throw std::invalid_argument("Bad coordinate: " + value);
+    }
+
+    return degrees;
+}
+
+void CheckZoom(int zoom)
+{
+    if (zoom < 0 || zoom > MAX_ZOOM)
+    {
+        throw std::invalid_argument("Zoom out of range: " +
+                                    std::to_string(zoom));
+    }
+}
+
+[[noreturn]] void ThrowTooManyTiles(size_t maxTiles, int zoom)
+{
+    throw std::invalid_argument("The selection has more than " +
+                                std::to_string(maxTiles) +
+                                " tiles at zoom " + std::to_string(zoom) +
+                                ", see maxTiles");
+}
+
+Region::Ring ReadRing(const nlohmann::json& coordinates)
+{
+    Region::Ring ring;
+
+    for (const auto& position : coordinates)
+    {
+        if (!position.is_array() || position.size() < 2)
+        {
+            throw std::invalid_argument("Bad GeoJSON position");
+        }
+
+        ring.emplace_back(position[0].get<double>(), position[1].get<double>());
+    }
+
+    return ring;
+}
+
+std::vector<Region::Ring> ReadPolygon(const nlohmann::json& coordinates)
+{
+    std::vector<Region::Ring> polygon;
+
+    for (const auto& ring : coordinates)
+    {
+        polygon.push_back(ReadRing(ring));
+    }
+
+    return polygon;
+}
+
+void ReadGeometry(const nlohmann::json& object, Region& region)
+{
+    if (!object.is_object() || !object.count("type"))
+    {
+        return;
+    }
+
+    const std::string type = object["type"].get<std::string>();
+
+    if (type == "Polygon")
+    {
+        region.polygons.push_back(ReadPolygon(object["coordinates"]));
+    }
+    else if (type == "MultiPolygon")
+    {
+        for (const auto& polygon : object["coordinates"])
+        {
+            region.polygons.push_back(ReadPolygon(polygon));
+        }
+    }
+    else if (type == "Feature")
+    {
+        ReadGeometry(object["geometry"], region);
+    }
+    else if (type == "FeatureCollection")
+    {
+        for (const auto& feature : object["features"])
+        {
+            ReadGeometry(feature, region);
+        }
+    }
+    else if (type == "GeometryCollection")
+    {
+        for (const auto& geometry : object["geometries"])
+        {
+            ReadGeometry(geometry, region);
+        }
+    }
+}
+
+//! Projects \p lonLat to fractional tile coordinates at \p zoom.
+glm::dvec2 ConvertLonLatToTileGrid(const glm::dvec2& lonLat, int zoom)
+{
+    const double n = std::ldexp(1.0, zoom);
+    const double lat = std::min(std::max(lonLat.y, -MAX_MERCATOR_LATITUDE),
+                                MAX_MERCATOR_LATITUDE) *
+                       MATH_PI * INV_180;
+
+    glm::dvec2 position(
+        (lonLat.x + 180.0) * INV_360 * n,
+        (1.0 - std::log(std::tan(lat) + 1.0 / std::cos(lat)) / MATH_PI) * 0.5 *
+            n);
+
+    // Snap to tile edges given in degrees, lest rounding adds a row of tiles
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        const double edge = std::round(position[axis]);
+        if (std::abs(position[axis] - edge) < 1e-6)
+        {
+            position[axis] = edge;
+        }
+    }
+
+    return position;
+}
+
+//! Adds the tiles whose interior the segment [a, b] passes through. The
+//! segment is cut where it crosses grid lines and each piece is located by
+//! its middle, so a piece running along a grid line adds nothing. Returns
+//! false when that would make more than \p maxTiles tiles.
+bool AddEdgeTiles(const glm::dvec2& a, const glm::dvec2& b, size_t maxTiles,
+                  TileSet& tiles)
+{
+    std::vector<double> cuts = { 0.0, 1.0 };
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (a[axis] == b[axis])
+        {
+            // Along a grid line the segment is in no tile
+            if (a[axis] == std::floor(a[axis]))
+            {
+                return true;
+            }
+
+            continue;
+        }
+
+        const double low = std::ceil(std::min(a[axis], b[axis]));
+        const double high = std::floor(std::max(a[axis], b[axis]));
+
+        // Every line crossed leads into another column or row
+        if (high - low >= static_cast<double>(maxTiles))
+        {
+            return false;
+        }
+
+        for (double line = low; line <= high; line += 1.0)
+        {
+            cuts.push_back((line - a[axis]) / (b[axis] - a[axis]));
+        }
+    }
+
+    std::sort(cuts.begin(), cuts.end());
+
+    for (size_t i = 0; i + 1 < cuts.size(); ++i)
+    {
+        const double t = 0.5 * (cuts[i] + cuts[i + 1]);
+        const glm::dvec2 middle = a + (b - a) * t;
+        const double cellX = std::floor(middle.x);
+        const double cellY = std::floor(middle.y);
+
+        if (middle.x != cellX && middle.y != cellY)
+        {
+            tiles.emplace(static_cast<int>(cellX), static_cast<int>(cellY));
+
+            if (tiles.size() > maxTiles)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//! Adds the tiles of each row between pairs of crossings of the polygon
+//! outline at the middle of the row, following the even-odd rule. Returns
+//! false when that would make more than \p maxTiles tiles.
+bool AddInteriorTiles(const std::vector<Region::Ring>& rings, double minY,
+                      double maxY, size_t maxTiles, TileSet& tiles)
+{
+    std::vector<double> crossings;
+
+    for (int y = static_cast<int>(std::floor(minY));
+         y <= static_cast<int>(std::floor(maxY)); ++y)
+    {
+        const double rowY = y + 0.5;
+        crossings.clear();
+
+        for (const auto& ring : rings)
+        {
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+            {
+                const glm::dvec2& p = ring[j];
+                const glm::dvec2& q = ring[i];
+
+                // Half-open in y, so a vertex on the row counts once
+                if ((p.y <= rowY) != (q.y <= rowY))
+                {
+                    const double t = (rowY - p.y) / (q.y - p.y);
+                    crossings.push_back(p.x + t * (q.x - p.x));
+                }
+            }
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2)
+        {
+            const int first = static_cast<int>(std::floor(crossings[i]));
+            const int last = static_cast<int>(std::ceil(crossings[i + 1])) - 1;
+
+            for (int x = first; x <= last; ++x)
+            {
+                tiles.emplace(x, y);
+
+                if (tiles.size() > maxTiles)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+}  // namespace
+
+Region ParseBoundingBox(const std::string& bbox)
+{
+    const std::vector<std::string> values = SplitString(bbox, ',');
+
+    if (values.size() != 4)
+    {
+        throw std::invalid_argument("Bad bounding box: " + bbox);
+    }
+
+    const double west = ParseDegrees(values[0]);
+    const double south = ParseDegrees(values[1]);
+    const double east = ParseDegrees(values[2]);
+    const double north = ParseDegrees(values[3]);
+
+    if (!(west < east) || !(south < north))
+    {
+        throw std::invalid_argument("Empty bounding box: " + bbox);
+    }
+
+    Region region;
+    region.polygons.push_back({ { { west, south },
+                                  { east, south },
+                                  { east, north },
+                                  { west, north } } });
+
+    return region;
+}
+
+Region LoadRegion(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+
+    if (!file.is_open())
+    {
+        throw std::invalid_argument("Failed to open region file: " + fileName);
+    }
+
+    Region region;
+
+    try
+    {
+        ReadGeometry(nlohmann::json::parse(file), region);
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        throw std::invalid_argument("Bad region file " + fileName + ": " +
+                                    e.what());
+    }
+
+    if (region.polygons.empty())
+    {
+        throw std::invalid_argument("No polygon in region file: " + fileName);
+    }
+
+    return region;
+}
+
+std::vector<glm::ivec2> CoverRegion(const Region& region, int zoom,
+                                    size_t maxTiles)
+{
+    CheckZoom(zoom);
+
+    TileSet tiles;
+
+    for (const auto& polygon : region.polygons)
+    {
+        std::vector<Region::Ring> rings;
+        double minY = std::numeric_limits<double>::max();
+        double maxY = std::numeric_limits<double>::lowest();
+
+        for (const auto& ring : polygon)
+        {
+            if (ring.empty())
+            {
+                continue;
+            }
+
+            Region::Ring projected;
+            projected.reserve(ring.size());
+
+            for (const auto& lonLat : ring)
+            {
+                projected.push_back(ConvertLonLatToTileGrid(lonLat, zoom));
+                minY = std::min(minY, projected.back().y);
+                maxY = std::max(maxY, projected.back().y);
+            }
+
+            // GeoJSON rings repeat their first position, others may not
+            for (size_t i = 0; i < projected.size(); ++i)
+            {
+                if (!AddEdgeTiles(projected[i],
+                                  projected[(i + 1) % projected.size()],
+                                  maxTiles, tiles))
+                {
+                    ThrowTooManyTiles(maxTiles, zoom);
+                }
+            }
+
+            rings.push_back(std::move(projected));
+        }
+
+        if (!rings.empty() &&
+            !AddInteriorTiles(rings, minY, maxY, maxTiles, tiles))
+        {
+            ThrowTooManyTiles(maxTiles, zoom);
+        }
+    }
+
+    // Drop what lies beyond the antimeridian or the Mercator limit
+    const int n = 1 << zoom;
+    std::vector<glm::ivec2> result;
+    result.reserve(tiles.size());
+
+    for (const auto& tile : tiles)
+    {
+        if (tile.first >= 0 && tile.first < n && tile.second >= 0 &&
+            tile.second < n)
+        {
+            result.emplace_back(tile.first, tile.second);
+        }
+    }
+
+    return result;
+}
+
+std::vector<glm::ivec2> CoverTileRange(int startX, int endX, int startY,
+                                       int endY, int z, int zoom,
+                                       size_t maxTiles)
+{
+    CheckZoom(z);
+    CheckZoom(zoom);
+
+    if (startX < 0 || startY < 0 || std::max(endX, endY) >= (1 << z))
+    {
+        throw std::invalid_argument("Tile out of range at zoom " +
+                                    std::to_string(z));
+    }
+
+    // Tiles split in four per zoom level, so the cover is exact
+    std::int64_t x0 = startX, x1 = endX, y0 = startY, y1 = endY;
+
+    if (zoom >= z)
+    {
+        const int shift = zoom - z;
+        x0 *= std::int64_t{ 1 } << shift;
+        y0 *= std::int64_t{ 1 } << shift;
+        x1 = (x1 + 1) * (std::int64_t{ 1 } << shift) - 1;
+        y1 = (y1 + 1) * (std::int64_t{ 1 } << shift) - 1;
+    }
+    else
+    {
+        const int shift = z - zoom;
+        x0 >>= shift;
+        y0 >>= shift;
+        x1 >>= shift;
+        y1 >>= shift;
+    }
+
+    const std::int64_t columns = std::max<std::int64_t>(x1 - x0 + 1, 0);
+    const std::int64_t rows = std::max<std::int64_t>(y1 - y0 + 1, 0);
+
+    if (rows > 0 && columns > static_cast<std::int64_t>(maxTiles) / rows)
+    {
+        ThrowTooManyTiles(maxTiles, zoom);
+    }
+
+    std::vector<glm::ivec2> result;
+    result.reserve(static_cast<size_t>(columns * rows));
+
+    for (std::int64_t x = x0; x <= x1; ++x)
+    {
+        for (std::int64_t y = y0; y <= y1; ++y)
+        {
+            result.emplace_back(static_cast<int>(x), static_cast<int>(y));
+        }
+    }
+
+    return result;
+}
+
+std::vector<glm::ivec2> SelectTiles(const ProgramConfig& config, int zoom)
+{
+    const size_t maxTiles = static_cast<size_t>(std::max(1, config.maxTiles));
+
+    if (!config.regionFile.empty())
+    {
+        return CoverRegion(LoadRegion(config.regionFile), zoom,
+                           maxTiles);
+    }
+
+    if (!config.region.empty())
+    {
+        return CoverRegion(ParseBoundingBox(config.region), zoom,
+                           maxTiles);
+    }
+
+    auto [startX, endX] = ExtractTileRange(config.tileX);
+    auto [startY, endY] = ExtractTileRange(config.tileY);
+
+    return CoverTileRange(startX, endX, startY, endY, config.tileZ, zoom,
+                          maxTiles);
+}
+}  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Geometry/TileJournal.hpp>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace CubbyCity
+{
+TileJournal::TileJournal(const std::string& fileName, bool resume)
+{
+    if (resume)
+    {
+        std::ifstream previous(fileName);
+        std::string line;
+
+        while (std::getline(previous, line))
+        {
+            std::istringstream stream(line);
+            std::string state, tile;
+
+            if (!(stream >> state >> tile))
+            {
+                continue;
+            }
+
+            for (const State s :
+                 { State::Downloaded, State::Built, State::Failed })
+            {
+                if (state == ToString(s))
+                {
+                    m_states[tile] = s;
+                }
+            }
+        }
+    }
+
+    m_file.open(fileName, resume ? std::ios::app : std::ios::trunc);
+
+    if (!m_file.is_open())
+    {
+        throw std::runtime_error("Failed to open journal file");
+    }
+}
+
+void TileJournal::Record(const Tile& tile, State state,
+                         const std::string& detail)
+{
+    m_states[tile.ToString()] = state;
+
+    m_file << ToString(state) << " " << tile.ToString();
+    if (!detail.empty())
+    {
+        m_file << " " << detail;
+    }
+    m_file << std::endl;
+}
+
+TileJournal::State TileJournal::GetState(const Tile& tile) const
+{
+    const auto it = m_states.find(tile.ToString());
+    return it != m_states.end() ? it->second : State::None;
+}
+
+const char* TileJournal::ToString(State state)
+{
+    switch (state)
+    {
+        case State::Downloaded:
+            return "downloaded";
+        case State::Built:
+            return "built";
+        case State::Failed:
+            return "failed";
+        default:
+            return "none";
+    }
+}
+}  // namespace CubbyCity
\ No newline at end of file
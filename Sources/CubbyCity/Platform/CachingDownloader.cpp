@@ -0,0 +1,59 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Platform/CachingDownloader.hpp>
+
+namespace CubbyCity
+{
+CachingDownloader::CachingDownloader(std::shared_ptr<IDownloader> downloader,
+                                     size_t capacityBytes)
+    : m_downloader(std::move(downloader)), m_cache(capacityBytes)
+{
+    // Do nothing
+}
+
+bool CachingDownloader::DownloadData(std::string& out, const std::string& url)
+{
+    Payload payload;
+
+    if (!Download(payload, url))
+    {
+        return false;
+    }
+
+    out.assign(payload.Data(), payload.Size());
+
+    return true;
+}
+
+bool CachingDownloader::Download(Payload& out, const std::string& url)
+{
+    if (m_cache.Get(url, out))
+    {
+        return true;
+    }
+
+    if (!m_downloader->Download(out, url))
+    {
+        return false;
+    }
+
+    m_cache.Put(url, out, out.Size());
+
+    return true;
+}
+
+std::string CachingDownloader::GetVersion(const std::string& url)
+{
+    return m_downloader->GetVersion(url);
+}
+
+void CachingDownloader::Evict(const std::string& url)
+{
+    m_cache.Erase(url);
+    m_downloader->Evict(url);
+}
+}  // namespace CubbyCity
\ No newline at end of file
@@ -8,46 +8,212 @@
 
 #include <curl/curl.h>
 
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
 
 namespace CubbyCity
 {
-bool CurlDownloader::DownloadData(std::string& out, const std::string& url)
+namespace
+{
+static_assert(CURL_LOCK_DATA_LAST <= 8,
+              "CurlDownloader needs a mutex per kind of shared data");
+
+struct Transfer
+{
+    std::string* out;
+    DownloadResult* result;
+};
+
+void InitializeCurl()
+{
+    // curl_global_init is not thread-safe, run it once per process
+    static std::once_flag flag;
+    std::call_once(flag, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+void LockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr)
 {
-    std::stringstream stream;
+    static_cast<std::mutex*>(userptr)[data].lock();
+}
+
+void UnlockShare(CURL*, curl_lock_data data, void* userptr)
+{
+    static_cast<std::mutex*>(userptr)[data].unlock();
+}
 
-    static bool curlInitialized = false;
-    static CURL* curlHandle = nullptr;
+bool StartsWith(const std::string& header, const std::string& name)
+{
+    return header.size() > name.size() &&
+           std::equal(name.begin(), name.end(), header.begin(),
+                      [](char a, char b) {
+                          return a ==
+                                 std::tolower(static_cast<unsigned char>(b));
+                      });
+}
+}  // namespace
+
+CurlDownloader::CurlDownloader(double timeout, double connectTimeout)
+    : m_timeout(timeout), m_connectTimeout(connectTimeout)
+{
+    InitializeCurl();
 
-    if (!curlInitialized)
+    CURLSH* share = curl_share_init();
+    if (!share)
     {
-        curl_global_init(CURL_GLOBAL_DEFAULT);
-        curlHandle = curl_easy_init();
-        curlInitialized = true;
+        throw std::runtime_error("Failed to initialize curl");
+    }
+
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, LockShare);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, m_shareMutexes);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+
+    m_share = share;
+}
 
-        // Set up curl to perform fetch
-        curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, WriteData);
-        curl_easy_setopt(curlHandle, CURLOPT_HEADER, 0L);
-        curl_easy_setopt(curlHandle, CURLOPT_VERBOSE, 0L);
-        curl_easy_setopt(curlHandle, CURLOPT_ACCEPT_ENCODING, "gzip");
-        curl_easy_setopt(curlHandle, CURLOPT_NOSIGNAL, 1L);
-        curl_easy_setopt(curlHandle, CURLOPT_DNS_CACHE_TIMEOUT, -1);
+CurlDownloader::~CurlDownloader()
+{
+    // Easy handles must let go of the share before it is cleaned up
+    for (void* handle : m_handles)
+    {
+        curl_easy_cleanup(handle);
     }
 
-    curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, &stream);
+    curl_share_cleanup(static_cast<CURLSH*>(m_share));
+}
+
+bool CurlDownloader::DownloadData(std::string& out, const std::string& url)
+{
+    return Fetch(out, url).ok;
+}
+
+DownloadResult CurlDownloader::Fetch(std::string& out, const std::string& url)
+{
+    DownloadResult result;
+
+    // The payload is written straight into out, reusing its capacity
+    out.clear();
+    Transfer transfer{ &out, &result };
+
+    CURL* curlHandle = AcquireHandle();
+
+    curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, &out);
+    curl_easy_setopt(curlHandle, CURLOPT_HEADERDATA, &transfer);
     curl_easy_setopt(curlHandle, CURLOPT_URL, url.c_str());
 
-    CURLcode result = curl_easy_perform(curlHandle);
+    const CURLcode code = curl_easy_perform(curlHandle);
 
-    out = stream.str();
-    return result == CURLE_OK && stream.rdbuf()->in_avail();
+    long status = 0;
+    curl_easy_getinfo(curlHandle, CURLINFO_RESPONSE_CODE, &status);
+    result.status = static_cast<int>(status);
+
+    ReleaseHandle(curlHandle);
+
+    if (code != CURLE_OK)
+    {
+        // Errors of the connection, as opposed to a bad URL or option
+        result.transient = code == CURLE_OPERATION_TIMEDOUT ||
+                           code == CURLE_COULDNT_RESOLVE_HOST ||
+                           code == CURLE_COULDNT_CONNECT ||
+                           code == CURLE_SEND_ERROR ||
+                           code == CURLE_RECV_ERROR ||
+                           code == CURLE_GOT_NOTHING ||
+                           code == CURLE_PARTIAL_FILE;
+    }
+    else if (status == 429 || status >= 500)
+    {
+        result.transient = true;
+    }
+    else
+    {
+        result.ok = status >= 200 && status < 300 && !out.empty();
+    }
+
+    return result;
+}
+
+void* CurlDownloader::AcquireHandle()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+
+        if (!m_handles.empty())
+        {
+            void* handle = m_handles.back();
+            m_handles.pop_back();
+            return handle;
+        }
+    }
+
+    CURL* curlHandle = curl_easy_init();
+    if (!curlHandle)
+    {
+        throw std::runtime_error("Failed to initialize curl");
+    }
+
+    // Set up curl to perform fetch
+    curl_easy_setopt(curlHandle, CURLOPT_SHARE, m_share);
+    curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, WriteData);
+    curl_easy_setopt(curlHandle, CURLOPT_HEADERFUNCTION, WriteHeader);
+    curl_easy_setopt(curlHandle, CURLOPT_HEADER, 0L);
+    curl_easy_setopt(curlHandle, CURLOPT_VERBOSE, 0L);
+    curl_easy_setopt(curlHandle, CURLOPT_ACCEPT_ENCODING, "gzip");
+    curl_easy_setopt(curlHandle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curlHandle, CURLOPT_DNS_CACHE_TIMEOUT, -1L);
+    // The shared cache keeps only this many idle connections, and the
+    // default of 5 closes most of them when several threads fetch at once
+    curl_easy_setopt(curlHandle, CURLOPT_MAXCONNECTS, 64L);
+    curl_easy_setopt(curlHandle, CURLOPT_TIMEOUT_MS,
+                     static_cast<long>(m_timeout * 1000.0));
+    curl_easy_setopt(curlHandle, CURLOPT_CONNECTTIMEOUT_MS,
+                     static_cast<long>(m_connectTimeout * 1000.0));
+
+    return curlHandle;
+}
+
+void CurlDownloader::ReleaseHandle(void* handle)
+{
+    std::lock_guard<std::mutex> lock(m_handleMutex);
+    m_handles.push_back(handle);
 }
 
 size_t CurlDownloader::WriteData(void* ptr, size_t size, const size_t nmemb,
                                  void* stream)
 {
-    static_cast<std::stringstream*>(stream)->write(reinterpret_cast<char*>(ptr),
-                                                   size * nmemb);
+    static_cast<std::string*>(stream)->append(static_cast<char*>(ptr),
+                                              size * nmemb);
     return size * nmemb;
 }
+
+size_t CurlDownloader::WriteHeader(char* buffer, size_t size, size_t nitems,
+                                   void* userdata)
+{
+    const std::string header(buffer, size * nitems);
+    const std::string retryAfter = "retry-after:";
+    const std::string contentLength = "content-length:";
+    auto* transfer = static_cast<Transfer*>(userdata);
+
+    if (StartsWith(header, retryAfter))
+    {
+        // Only the delay in seconds form is understood, not HTTP dates
+        transfer->result->retryAfter =
+            std::atof(header.c_str() + retryAfter.size());
+    }
+    else if (StartsWith(header, contentLength))
+    {
+        // Grow the buffer once; a compressed length is still a lower bound
+        const long long length =
+            std::atoll(header.c_str() + contentLength.size());
+        if (length > 0 && length < (1LL << 30))
+        {
+            transfer->out->reserve(static_cast<size_t>(length));
+        }
+    }
+
+    return size * nitems;
+}
 }  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,88 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Platform/DiskCachingDownloader.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace CubbyCity
+{
+DiskCachingDownloader::DiskCachingDownloader(
+    std::shared_ptr<IDownloader> downloader, std::string directory)
+    : m_downloader(std::move(downloader)), m_local(std::move(directory))
+{
+    // Do nothing
+}
+
+bool DiskCachingDownloader::DownloadData(std::string& out,
+                                         const std::string& url)
+{
+    Payload payload;
+
+    if (!Download(payload, url))
+    {
+        return false;
+    }
+
+    out.assign(payload.Data(), payload.Size());
+
+    return true;
+}
+
+bool DiskCachingDownloader::Download(Payload& out, const std::string& url)
+{
+    if (m_local.Download(out, url))
+    {
+        return true;
+    }
+
+    if (!m_downloader->Download(out, url))
+    {
+        return false;
+    }
+
+    const std::filesystem::path path = m_local.GetFilePath(url);
+
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    std::random_device random;
+    const std::filesystem::path tempPath =
+        path.string() + "." + std::to_string(random()) + ".tmp";
+
+    std::ofstream file(tempPath, std::ios::out | std::ios::binary);
+    file.write(out.Data(), static_cast<std::streamsize>(out.Size()));
+    file.close();
+
+    // Failing to keep a copy does not fail the download
+    if (file.good())
+    {
+        std::filesystem::rename(tempPath, path, error);
+    }
+
+    if (!file.good() || error)
+    {
+        std::filesystem::remove(tempPath, error);
+    }
+
+    return true;
+}
+
+std::string DiskCachingDownloader::GetVersion(const std::string& url)
+{
+    return m_downloader->GetVersion(url);
+}
+
+void DiskCachingDownloader::Evict(const std::string& url)
+{
+    std::error_code error;
+    std::filesystem::remove(m_local.GetFilePath(url), error);
+
+    m_downloader->Evict(url);
+}
+}  // namespace CubbyCity
\ No newline at end of file
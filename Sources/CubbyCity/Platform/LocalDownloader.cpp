@@ -0,0 +1,165 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/Macros.hpp>
+#include <CubbyCity/Platform/LocalDownloader.hpp>
+
+#if defined(CUBBYCITY_WINDOWS)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <filesystem>
+#include <fstream>
+
+namespace CubbyCity
+{
+namespace
+{
+#if defined(CUBBYCITY_WINDOWS)
+bool MapFile(const std::string& path, Payload& out)
+{
+    const HANDLE file =
+        CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+
+    // Empty files cannot be mapped, and are not tiles either
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        mapping =
+            CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+
+    CloseHandle(file);
+
+    if (!mapping)
+    {
+        return false;
+    }
+
+    // The view keeps the mapping alive once mapped
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!view)
+    {
+        return false;
+    }
+
+    std::shared_ptr<const void> owner(
+        view, [](const void* data) { UnmapViewOfFile(data); });
+    out = Payload(std::move(owner), static_cast<const char*>(view),
+                  static_cast<size_t>(size.QuadPart));
+
+    return true;
+}
+#else
+bool MapFile(const std::string& path, Payload& out)
+{
+    const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    void* data = MAP_FAILED;
+
+    // Empty files cannot be mapped, and are not tiles either
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ,
+                    MAP_PRIVATE, file, 0);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(file);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const auto size = static_cast<size_t>(status.st_size);
+    std::shared_ptr<const void> owner(data, [size](const void* mapped) {
+        munmap(const_cast<void*>(mapped), size);
+    });
+    out = Payload(std::move(owner), static_cast<const char*>(data), size);
+
+    return true;
+}
+#endif
+}  // namespace
+
+LocalDownloader::LocalDownloader(std::string rootDir)
+    : m_rootDir(std::move(rootDir))
+{
+    // Do nothing
+}
+
+bool LocalDownloader::DownloadData(std::string& out, const std::string& url)
+{
+    std::ifstream file(GetFilePath(url), std::ios::in | std::ios::binary);
+
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    out.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(&out[0], static_cast<std::streamsize>(out.size()));
+
+    return file.good() && !out.empty();
+}
+
+bool LocalDownloader::Download(Payload& out, const std::string& url)
+{
+    return MapFile(GetFilePath(url), out);
+}
+
+std::string LocalDownloader::GetVersion(const std::string& url)
+{
+    const std::string path = GetFilePath(url);
+
+    std::error_code sizeError;
+    std::error_code timeError;
+    const auto size = std::filesystem::file_size(path, sizeError);
+    const auto time = std::filesystem::last_write_time(path, timeError);
+
+    if (sizeError || timeError)
+    {
+        return path;
+    }
+
+    return path + ":" + std::to_string(size) + ":" +
+           std::to_string(time.time_since_epoch().count());
+}
+
+std::string LocalDownloader::GetFilePath(const std::string& url) const
+{
+    size_t begin = url.find("://");
+    begin = begin == std::string::npos ? 0 : begin + 3;
+
+    const size_t end = url.find('?', begin);
+
+    return m_rootDir + "/" + url.substr(begin, end - begin);
+}
+}  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,110 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Platform/RetryingDownloader.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace CubbyCity
+{
+namespace
+{
+std::string GetHost(const std::string& url)
+{
+    size_t begin = url.find("://");
+    begin = begin == std::string::npos ? 0 : begin + 3;
+
+    return url.substr(begin, url.find('/', begin) - begin);
+}
+
+double GetJitter(double maxDelay)
+{
+    thread_local std::mt19937 random{ std::random_device()() };
+
+    return std::uniform_real_distribution<double>(0.0, maxDelay)(random);
+}
+}  // namespace
+
+RetryingDownloader::RetryingDownloader(std::shared_ptr<IDownloader> downloader,
+                                       DownloadPolicy policy)
+    : m_downloader(std::move(downloader)), m_policy(policy)
+{
+    // Do nothing
+}
+
+bool RetryingDownloader::DownloadData(std::string& out, const std::string& url)
+{
+    return Fetch(out, url).ok;
+}
+
+DownloadResult RetryingDownloader::Fetch(std::string& out,
+                                         const std::string& url)
+{
+    TokenBucket& bucket = GetBucket(url);
+
+    for (int attempt = 0;; ++attempt)
+    {
+        bucket.Acquire();
+
+        out.clear();
+        const DownloadResult result = m_downloader->Fetch(out, url);
+
+        // Waiting longer than maxRetryDelay for the server would park the
+        // run and every request to the host, so such an answer is final
+        if (result.ok || !result.transient || attempt >= m_policy.retries ||
+            result.retryAfter > m_policy.maxRetryDelay)
+        {
+            return result;
+        }
+
+        ++m_numRetries;
+
+        const double backoff = m_policy.retryDelay * std::pow(2.0, attempt);
+        double delay = GetJitter(std::min(m_policy.maxRetryDelay, backoff));
+
+        if (result.retryAfter > 0.0)
+        {
+            bucket.Pause(result.retryAfter);
+            delay = std::max(delay, result.retryAfter);
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+    }
+}
+
+std::string RetryingDownloader::GetVersion(const std::string& url)
+{
+    return m_downloader->GetVersion(url);
+}
+
+void RetryingDownloader::Evict(const std::string& url)
+{
+    m_downloader->Evict(url);
+}
+
+size_t RetryingDownloader::GetNumRetries() const
+{
+    return m_numRetries;
+}
+
+TokenBucket& RetryingDownloader::GetBucket(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto& bucket = m_buckets[GetHost(url)];
+    if (!bucket)
+    {
+        bucket = std::make_unique<TokenBucket>(m_policy.rateLimit,
+                                               m_policy.rateBurst);
+    }
+
+    return *bucket;
+}
+}  // namespace CubbyCity
\ No newline at end of file
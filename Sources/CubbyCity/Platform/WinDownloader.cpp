@@ -19,10 +19,22 @@
 
 namespace CubbyCity
 {
+WinDownloader::WinDownloader(double timeout, double connectTimeout)
+    : m_timeout(timeout), m_connectTimeout(connectTimeout)
+{
+    // Do nothing
+}
+
 bool WinDownloader::DownloadData(std::string& out, const std::string& url)
+{
+    return Fetch(out, url).ok;
+}
+
+DownloadResult WinDownloader::Fetch(std::string& out, const std::string& url)
 {
     std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
     std::vector<char> stream;
+    DownloadResult result;
 
     URL_COMPONENTS uc;
     wchar_t scheme[256];
@@ -54,7 +66,7 @@ bool WinDownloader::DownloadData(std::string& out, const std::string& url)
     if (!WinHttpCrackUrl(wURL.c_str(), static_cast<DWORD>(wURL.size()),
                          ICU_ESCAPE, &uc))
     {
-        return false;
+        return result;
     }
 
     DWORD flags = 0;
@@ -68,7 +80,7 @@ bool WinDownloader::DownloadData(std::string& out, const std::string& url)
             flags |= WINHTTP_FLAG_SECURE;
             break;
         default:
-            return false;
+            return result;
     }
 
     HINTERNET session =
@@ -76,14 +88,21 @@ bool WinDownloader::DownloadData(std::string& out, const std::string& url)
                     WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
     if (session == nullptr)
     {
-        return false;
+        return result;
     }
 
+    // A timeout of 0 means infinite for WinHTTP as well
+    const int timeout = static_cast<int>(m_timeout * 1000.0);
+    const int connectTimeout = static_cast<int>(m_connectTimeout * 1000.0);
+    WinHttpSetTimeouts(session, connectTimeout, connectTimeout, timeout,
+                       timeout);
+
     HINTERNET hConnect = WinHttpConnect(session, uc.lpszHostName, uc.nPort, 0);
     if (hConnect == nullptr)
     {
         WinHttpCloseHandle(session);
-        return false;
+        result.transient = true;
+        return result;
     }
 
     std::wstring objectName = uc.lpszUrlPath;
@@ -100,12 +119,34 @@ bool WinDownloader::DownloadData(std::string& out, const std::string& url)
     {
         WinHttpCloseHandle(hConnect);
         WinHttpCloseHandle(session);
-        return false;
+        return result;
     }
 
     bool noError = WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS,
                                       0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0) != 0;
     noError = noError && (WinHttpReceiveResponse(hRequest, nullptr) != 0);
+
+    if (noError)
+    {
+        DWORD status = 0;
+        DWORD statusLength = sizeof(status);
+        WinHttpQueryHeaders(
+            hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+            WINHTTP_HEADER_NAME_BY_INDEX, &status, &statusLength,
+            WINHTTP_NO_HEADER_INDEX);
+        result.status = static_cast<int>(status);
+
+        DWORD retryAfter = 0;
+        DWORD retryAfterLength = sizeof(retryAfter);
+        if (WinHttpQueryHeaders(
+                hRequest, WINHTTP_QUERY_RETRY_AFTER | WINHTTP_QUERY_FLAG_NUMBER,
+                WINHTTP_HEADER_NAME_BY_INDEX, &retryAfter, &retryAfterLength,
+                WINHTTP_NO_HEADER_INDEX))
+        {
+            result.retryAfter = static_cast<double>(retryAfter);
+        }
+    }
+
     wchar_t encoding[128] = { 0 };
     DWORD encodingLength = sizeof(encoding);
     if (WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_CONTENT_ENCODING, nullptr,
@@ -144,6 +185,16 @@ bool WinDownloader::DownloadData(std::string& out, const std::string& url)
 
     out = std::string(stream.begin(), stream.end());
 
-    return noError;
+    // Connection errors and timeouts may go away, as may overload
+    if (!noError || result.status == 429 || result.status >= 500)
+    {
+        result.transient = true;
+    }
+    else
+    {
+        result.ok = result.status >= 200 && result.status < 300;
+    }
+
+    return result;
 }
 }  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,220 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Geometry/TileCover.hpp>
+#include <CubbyCity/Geometry/TileUtils.hpp>
+#include <CubbyCity/Platform/DiskCachingDownloader.hpp>
+#include <CubbyCity/Platform/DownloadUtils.hpp>
+#include <CubbyCity/Programs/Prefetcher.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace CubbyCity
+{
+namespace
+{
+enum class Status
+{
+    Cached,
+    Fetched,
+    Failed
+};
+
+struct Request
+{
+    int zoom;
+    std::string name;
+    std::string url;
+    Status status = Status::Failed;
+};
+}  // namespace
+
+Prefetcher::Prefetcher(ProgramConfig config,
+                       std::shared_ptr<IDownloader> downloader)
+    : m_config(std::move(config)), m_downloader(std::move(downloader))
+{
+    m_profiler.EnableTrace(!m_config.traceFile.empty());
+}
+
+nlohmann::json Prefetcher::Run()
+{
+    ScopedTimer timer(&m_profiler, "prefetch");
+
+    if (m_config.tileCacheDir.empty())
+    {
+        throw std::invalid_argument("Prefetching needs a tileCacheDir");
+    }
+
+    int minZoom = m_config.tileZ;
+    int maxZoom = m_config.tileZ;
+
+    if (!m_config.prefetchZoom.empty())
+    {
+        std::tie(minZoom, maxZoom) = ExtractTileRange(m_config.prefetchZoom);
+    }
+
+    if (minZoom < 0 || maxZoom > MAX_ZOOM)
+    {
+        throw std::invalid_argument("Bad prefetch zoom range");
+    }
+
+    if (!m_downloader)
+    {
+        m_downloader = CreateDownloader(m_config);
+    }
+
+    // Only the layers the job is going to build
+    const bool terrain = m_config.terrain;
+    const bool tileData = m_config.buildings || m_config.roads;
+
+    std::vector<Request> requests;
+    std::map<int, size_t> numTiles;
+
+    for (int zoom = minZoom; zoom <= maxZoom; ++zoom)
+    {
+        const std::vector<glm::ivec2> tiles = SelectTiles(m_config, zoom);
+        numTiles[zoom] = tiles.size();
+
+        for (const auto& position : tiles)
+        {
+            const Tile tile(position.x, position.y, zoom);
+
+            if (terrain)
+            {
+                requests.push_back(
+                    { zoom, "terrain " + tile.ToString(),
+                      GetTerrainURL(tile, m_config.apiKey,
+                                    m_config.tileEndpoint) });
+            }
+
+            if (tileData)
+            {
+                requests.push_back(
+                    { zoom, "vector " + tile.ToString(),
+                      GetVectorTileURL(tile, m_config.apiKey,
+                                       m_config.tileEndpoint) });
+            }
+        }
+    }
+
+    const LocalDownloader cache(m_config.tileCacheDir);
+    DiskCachingDownloader downloader(m_downloader, m_config.tileCacheDir);
+    std::atomic<size_t> next{ 0 };
+
+    // Each worker takes the next request; the rate limiter of the downloader
+    // keeps the hosts from being flooded
+    const auto work = [&] {
+        for (size_t i = next++; i < requests.size(); i = next++)
+        {
+            Request& request = requests[i];
+
+            std::error_code error;
+            const auto size = std::filesystem::file_size(
+                cache.GetFilePath(request.url), error);
+
+            if (!error && size > 0)
+            {
+                request.status = Status::Cached;
+                continue;
+            }
+
+            ScopedTrace trace(&m_profiler, request.name, "prefetch");
+            Payload payload;
+
+            request.status =
+                DownloadPayload(downloader, payload, request.url, &m_profiler)
+                    ? Status::Fetched
+                    : Status::Failed;
+        }
+    };
+
+    const size_t numThreads =
+        std::min(requests.size(),
+                 static_cast<size_t>(std::max(1, m_config.prefetchThreads)));
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < numThreads; ++i)
+    {
+        threads.emplace_back(work);
+    }
+
+    work();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::map<int, std::map<std::string, size_t>> counts;
+    nlohmann::json failed = nlohmann::json::array();
+
+    for (const auto& request : requests)
+    {
+        auto& zoomCounts = counts[request.zoom];
+        ++zoomCounts["payloads"];
+
+        switch (request.status)
+        {
+            case Status::Cached:
+                ++zoomCounts["cached"];
+                break;
+            case Status::Fetched:
+                ++zoomCounts["fetched"];
+                break;
+            default:
+                ++zoomCounts["failed"];
+                failed.push_back(request.name);
+                break;
+        }
+    }
+
+    nlohmann::json report;
+    report["zooms"] = nlohmann::json::object();
+    size_t total = 0;
+
+    for (const auto& zoomTiles : numTiles)
+    {
+        auto& entry = counts[zoomTiles.first];
+        const size_t payloads = entry["payloads"];
+        const size_t present = entry["cached"] + entry["fetched"];
+
+        report["zooms"][std::to_string(zoomTiles.first)] = {
+            { "tiles", zoomTiles.second },
+            { "payloads", payloads },
+            { "cached", entry["cached"] },
+            { "fetched", entry["fetched"] },
+            { "failed", entry["failed"] },
+            { "coverage",
+              payloads > 0 ? static_cast<double>(present) / payloads : 1.0 }
+        };
+
+        total += payloads;
+        m_profiler.AddCount("cached", entry["cached"]);
+        m_profiler.AddCount("fetched", entry["fetched"]);
+        m_profiler.AddCount("failed", entry["failed"]);
+    }
+
+    report["payloads"] = total;
+    report["coverage"] =
+        total > 0 ? static_cast<double>(total - failed.size()) / total : 1.0;
+    report["failed"] = failed;
+
+    return report;
+}
+
+const Profiler& Prefetcher::GetProfiler() const
+{
+    return m_profiler;
+}
+}  // namespace CubbyCity
\ No newline at end of file
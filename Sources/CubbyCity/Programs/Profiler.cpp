@@ -0,0 +1,227 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Programs/Profiler.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace CubbyCity
+{
+Profiler::Profiler() : m_epoch(Clock::now())
+{
+    // Do nothing
+}
+
+void Profiler::AddTime(const std::string& stage, double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stage& entry = m_stages[stage];
+    entry.seconds += seconds;
+    ++entry.calls;
+}
+
+void Profiler::AddCount(const std::string& counter, std::uint64_t value)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_counters[counter] += value;
+}
+
+double Profiler::GetSeconds(const std::string& stage) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_stages.find(stage);
+    return it != m_stages.end() ? it->second.seconds : 0.0;
+}
+
+std::uint64_t Profiler::GetCalls(const std::string& stage) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_stages.find(stage);
+    return it != m_stages.end() ? it->second.calls : 0;
+}
+
+std::uint64_t Profiler::GetCount(const std::string& counter) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_counters.find(counter);
+    return it != m_counters.end() ? it->second : 0;
+}
+
+nlohmann::json Profiler::ToJSON() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    nlohmann::json report;
+    report["stages"] = nlohmann::json::object();
+    report["counters"] = nlohmann::json::object();
+
+    for (const auto& stage : m_stages)
+    {
+        report["stages"][stage.first] = { { "seconds", stage.second.seconds },
+                                          { "calls", stage.second.calls } };
+    }
+
+    for (const auto& counter : m_counters)
+    {
+        report["counters"][counter.first] = counter.second;
+    }
+
+    return report;
+}
+
+void Profiler::SaveJSON(const std::string& fileName) const
+{
+    std::ofstream file(fileName);
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open profile report file");
+    }
+
+    file << ToJSON().dump(4) << "\n";
+}
+
+void Profiler::EnableTrace(bool enable)
+{
+    m_traceEnabled = enable;
+}
+
+bool Profiler::IsTraceEnabled() const
+{
+    return m_traceEnabled;
+}
+
+void Profiler::AddTraceEvent(const std::string& name,
+                             const std::string& category,
+                             Clock::time_point start, Clock::time_point end)
+{
+    if (!m_traceEnabled)
+    {
+        return;
+    }
+
+    const std::chrono::duration<double, std::micro> begin = start - m_epoch;
+    const std::chrono::duration<double, std::micro> duration = end - start;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_traceEvents.push_back(
+        { name, category, GetThreadID(), begin.count(), duration.count() });
+}
+
+nlohmann::json Profiler::ToChromeTrace() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    nlohmann::json events = nlohmann::json::array();
+
+    for (const auto& thread : m_threadIDs)
+    {
+        const std::string name =
+            thread.second == 0 ? "main"
+                               : "worker " + std::to_string(thread.second);
+
+        events.push_back({ { "name", "thread_name" },
+                           { "ph", "M" },
+                           { "pid", 1 },
+                           { "tid", thread.second },
+                           { "args", { { "name", name } } } });
+    }
+
+    for (const auto& event : m_traceEvents)
+    {
+        events.push_back({ { "name", event.name },
+                           { "cat", event.category },
+                           { "ph", "X" },
+                           { "ts", event.start },
+                           { "dur", event.duration },
+                           { "pid", 1 },
+                           { "tid", event.threadID } });
+    }
+
+    return { { "traceEvents", events }, { "displayTimeUnit", "ms" } };
+}
+
+void Profiler::SaveChromeTrace(const std::string& fileName) const
+{
+    std::ofstream file(fileName);
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open trace file");
+    }
+
+    file << ToChromeTrace().dump() << "\n";
+}
+
+void Profiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stages.clear();
+    m_counters.clear();
+    m_traceEvents.clear();
+    m_threadIDs.clear();
+    m_epoch = Clock::now();
+}
+
+std::uint32_t Profiler::GetThreadID()
+{
+    // Called with the mutex held; the first thread seen is reported as main
+    const auto result = m_threadIDs.emplace(
+        std::this_thread::get_id(),
+        static_cast<std::uint32_t>(m_threadIDs.size()));
+
+    return result.first->second;
+}
+
+ScopedTimer::ScopedTimer(Profiler* profiler, std::string stage)
+    : m_profiler(profiler),
+      m_stage(std::move(stage)),
+      m_start(Profiler::Clock::now())
+{
+    // Do nothing
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (m_profiler)
+    {
+        const auto end = Profiler::Clock::now();
+        const std::chrono::duration<double> elapsed = end - m_start;
+
+        m_profiler->AddTime(m_stage, elapsed.count());
+        m_profiler->AddTraceEvent(m_stage, "stage", m_start, end);
+    }
+}
+
+ScopedTrace::ScopedTrace(Profiler* profiler, std::string name,
+                         std::string category)
+    : m_profiler(profiler && profiler->IsTraceEnabled() ? profiler : nullptr),
+      m_start(Profiler::Clock::now())
+{
+    if (m_profiler)
+    {
+        m_name = std::move(name);
+        m_category = std::move(category);
+    }
+}
+
+ScopedTrace::~ScopedTrace()
+{
+    if (m_profiler)
+    {
+        m_profiler->AddTraceEvent(m_name, m_category, m_start,
+                                  Profiler::Clock::now());
+    }
+}
+}  // namespace CubbyCity
\ No newline at end of file
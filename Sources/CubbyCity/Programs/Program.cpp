@@ -4,28 +4,64 @@
 // personal capacity and are not conveying any rights to any intellectual
 // property of any third parties.
 
+#include <CubbyCity/Geometry/TileCover.hpp>
 #include <CubbyCity/Programs/Program.hpp>
 
 namespace CubbyCity
 {
-Program::Program(ProgramConfig config)
-    : m_config(std::move(config)), m_geometry(config)
+Program::Program(ProgramConfig config,
+                 std::shared_ptr<IDownloader> downloader,
+                 std::shared_ptr<TileCache> tileCache)
+    : m_config(std::move(config)),
+      m_geometry(m_config, std::move(downloader), std::move(tileCache))
 {
-    // Do nothing
+    m_geometry.GetProfiler().EnableTrace(!m_config.traceFile.empty());
 }
 
 void Program::Process()
 {
-    m_geometry.ParseTiles(m_config.tileX, m_config.tileY, m_config.tileZ);
-    m_geometry.DownloadData(m_config.apiKey, m_config.terrain,
-                            m_config.terrainExtrusionScale, m_config.buildings,
-                            m_config.roads);
+    {
+        ScopedTimer timer(&m_geometry.GetProfiler(), "process");
+
+        m_geometry.ParseTiles(SelectTiles(m_config, m_config.tileZ),
+                              m_config.tileZ);
+
+        if (m_config.synthetic)
+        {
+            m_geometry.GenerateData(CityGenerator(m_config.cityGenerator),
+                                    m_config.terrain,
+                                    m_config.terrainExtrusionScale,
+                                    m_config.buildings, m_config.roads);
+        }
+        else
+        {
+            m_geometry.DownloadData(m_config.apiKey, m_config.terrain,
+                                    m_config.terrainExtrusionScale,
+                                    m_config.buildings, m_config.roads);
+        }
+
+        if (m_config.terrain)
+        {
+            m_geometry.AdjustTerrainEdges();
+        }
+
+        m_geometry.BuildMeshes();
+        m_geometry.ExportToFile();
+    }
 
-    if (m_config.terrain)
+    if (!m_config.profileFile.empty())
     {
-        m_geometry.AdjustTerrainEdges();
+        m_geometry.GetProfiler().SaveJSON(m_config.profileFile);
     }
 
-    m_geometry.BuildMeshes();
+    if (!m_config.traceFile.empty())
+    {
+        m_geometry.GetProfiler().SaveChromeTrace(m_config.traceFile);
+    }
+}
+
+const Profiler& Program::GetProfiler() const
+{
+    return m_geometry.GetProfiler();
 }
 }  // namespace CubbyCity
\ No newline at end of file
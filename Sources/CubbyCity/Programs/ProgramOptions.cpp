@@ -0,0 +1,521 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Platform/TileURLs.hpp>
+#include <CubbyCity/Programs/ProgramOptions.hpp>
+
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace CubbyCity
+{
+namespace
+{
+using Setter = std::function<void(ProgramConfig&, const std::string&)>;
+using Getter = std::function<std::string(const ProgramConfig&)>;
+
+struct Option
+{
+    Setter set;
+    Getter get;
+    std::string type;
+    std::string description;
+};
+
+bool ParseBool(const std::string& value)
+{
+    if (value == "true" || value == "1" || value == "on")
+    {
+        return true;
+    }
+
+    if (value == "false" || value == "0" || value == "off")
+    {
+        return false;
+    }
+
+    throw std::invalid_argument("Bad boolean value: " + value);
+}
+
+template <typename T>
+T ParseNumber(const std::string& value)
+{
+    std::istringstream stream(value);
+    T result;
+
+    if (!(stream >> result) || !stream.eof())
+    {
+        throw std::invalid_argument("Bad numeric value: " + value);
+    }
+
+    return result;
+}
+
+NormalWeighting ParseNormalWeighting(const std::string& value)
+{
+    if (value == "uniform")
+    {
+        return NormalWeighting::Uniform;
+    }
+
+    if (value == "area")
+    {
+        return NormalWeighting::Area;
+    }
+
+    if (value == "angle")
+    {
+        return NormalWeighting::Angle;
+    }
+
+    throw std::invalid_argument("Bad normal weighting: " + value);
+}
+
+std::string ToString(NormalWeighting weighting)
+{
+    switch (weighting)
+    {
+        case NormalWeighting::Area:
+            return "area";
+        case NormalWeighting::Angle:
+            return "angle";
+        default:
+            return "uniform";
+    }
+}
+
+template <typename T>
+std::string ToString(const T& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        return value ? "true" : "false";
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        return value;
+    }
+    else
+    {
+        // Round-trips through ParseNumber
+        std::ostringstream stream;
+        stream.precision(17);
+        stream << value;
+        return stream.str();
+    }
+}
+
+template <typename T>
+T ParseNumber(const std::string& value, T min, T max)
+{
+    const T result = ParseNumber<T>(value);
+
+    // Written so that NaN is out of range too
+    if (!(result >= min && result <= max))
+    {
+        throw std::invalid_argument("Value out of range [" + ToString(min) +
+                                    ", " + ToString(max) + "]: " + value);
+    }
+
+    return result;
+}
+
+template <typename T>
+Option MakeOption(T ProgramConfig::*field, std::string description)
+{
+    Option option;
+    option.description = std::move(description);
+    option.get = [field](const ProgramConfig& config) {
+        return ToString(config.*field);
+    };
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        option.type = "flag";
+        option.set = [field](ProgramConfig& config, const std::string& value) {
+            config.*field = ParseBool(value);
+        };
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        option.type = "string";
+        option.set = [field](ProgramConfig& config, const std::string& value) {
+            config.*field = value;
+        };
+    }
+    else
+    {
+        option.type = "number";
+        option.set = [field](ProgramConfig& config, const std::string& value) {
+            config.*field = ParseNumber<T>(value);
+        };
+    }
+
+    return option;
+}
+
+//! Numeric option refusing values outside [\p min, \p max].
+template <typename T>
+Option MakeOption(T ProgramConfig::*field, std::string description, T min,
+                  T max)
+{
+    Option option = MakeOption(field, std::move(description));
+    option.set = [field, min, max](ProgramConfig& config,
+                                   const std::string& value) {
+        config.*field = ParseNumber<T>(value, min, max);
+    };
+
+    return option;
+}
+
+template <typename T>
+Option MakeCityOption(T CityGeneratorConfig::*field, std::string description)
+{
+    Option option;
+    option.type = "number";
+    option.description = std::move(description);
+    option.set = [field](ProgramConfig& config, const std::string& value) {
+        config.cityGenerator.*field = ParseNumber<T>(value);
+    };
+    option.get = [field](const ProgramConfig& config) {
+        return ToString(config.cityGenerator.*field);
+    };
+
+    return option;
+}
+
+template <typename T>
+Option MakeCityOption(T CityGeneratorConfig::*field, std::string description,
+                      T min, T max)
+{
+    Option option = MakeCityOption(field, std::move(description));
+    option.set = [field, min, max](ProgramConfig& config,
+                                   const std::string& value) {
+        config.cityGenerator.*field = ParseNumber<T>(value, min, max);
+    };
+
+    return option;
+}
+
+const std::map<std::string, Option>& GetOptions()
+{
+    static const std::map<std::string, Option> options = [] {
+        std::map<std::string, Option> o;
+        using C = ProgramConfig;
+        using G = CityGeneratorConfig;
+
+        o["apiKey"] = MakeOption(&C::apiKey, "Nextzen API key");
+        o["tileSource"] = MakeOption(
+            &C::tileSource, "Directory to read tiles from instead of the API");
+        o["tileEndpoint"] =
+            MakeOption(&C::tileEndpoint, "Base URL of the tile server");
+        o["tileX"] = MakeOption(&C::tileX, "Tile column or range \"x0/x1\"");
+        o["tileY"] = MakeOption(&C::tileY, "Tile row or range \"y0/y1\"");
+        o["tileZ"] = MakeOption(&C::tileZ, "Zoom level", 0, MAX_ZOOM);
+        o["region"] = MakeOption(
+            &C::region, "Tiles in \"west,south,east,north\" (degrees)");
+        o["regionFile"] =
+            MakeOption(&C::regionFile, "Tiles in the polygons of a GeoJSON");
+        o["prefetchZoom"] = MakeOption(
+            &C::prefetchZoom, "Prefetch zoom or range \"z0/z1\", or tileZ");
+        o["prefetchThreads"] = MakeOption(
+            &C::prefetchThreads, "Prefetch requests at once", 1, 256);
+        o["maxTiles"] =
+            MakeOption(&C::maxTiles, "Most tiles a selection may hold", 1,
+                       std::numeric_limits<int>::max());
+        o["terrainSubdivision"] =
+            MakeOption(&C::terrainSubdivision,
+                       "Terrain grid cells along a tile side", 1, 4096);
+        o["terrainExtrusionScale"] = MakeOption(
+            &C::terrainExtrusionScale, "Terrain height scale", 0.0, 1e3);
+        o["buildingsHeight"] =
+            MakeOption(&C::buildingsHeight,
+                       "Height of buildings without height data", 0.0, 1e4);
+        o["buildingsExtrusionScale"] = MakeOption(
+            &C::buildingsExtrusionScale, "Building height scale", 0.0, 1e3);
+        o["roadsHeight"] =
+            MakeOption(&C::roadsHeight, "Road height (m)", 0.0, 1e3);
+        o["roadsExtrusionWidth"] = MakeOption(
+            &C::roadsExtrusionWidth, "Road half width (m)", 0.0, 1e3);
+        o["pedestalHeight"] =
+            MakeOption(&C::pedestalHeight, "Pedestal height (m)", 0.0, 1e4);
+        o["simplifyRatio"] =
+            MakeOption(&C::simplifyRatio,
+                       "Fraction of triangles kept by simplify", 0.0, 1.0);
+        o["simplifyMaxError"] = MakeOption(
+            &C::simplifyMaxError, "Largest simplification error (m)", 0.0, 1e6);
+        o["downloadCacheSize"] =
+            MakeOption(&C::downloadCacheSize,
+                       "Payload cache shared by jobs (MB)", 0, 1 << 20);
+        o["decodedCacheSize"] =
+            MakeOption(&C::decodedCacheSize,
+                       "Decoded tile cache shared by jobs (MB)", 0, 1 << 20);
+        o["serverCacheSize"] =
+            MakeOption(&C::serverCacheSize,
+                       "Tile and mesh caches of --serve (MB)", 0, 1 << 20);
+        o["retries"] = MakeOption(
+            &C::retries, "Attempts after a tile fails to fetch", 0, 100);
+        o["timeout"] = MakeOption(&C::timeout, "Request timeout (s), 0 = none",
+                                  0.0, 86400.0);
+        o["connectTimeout"] =
+            MakeOption(&C::connectTimeout, "Connection timeout (s), 0 = none",
+                       0.0, 86400.0);
+        o["downloadRetries"] =
+            MakeOption(&C::downloadRetries,
+                       "Attempts after a timeout, 429 or 5xx", 0, 100);
+        o["retryDelay"] = MakeOption(
+            &C::retryDelay, "First backoff delay (s), doubling", 0.0, 3600.0);
+        o["maxRetryDelay"] = MakeOption(
+            &C::maxRetryDelay, "Largest backoff delay (s)", 0.0, 86400.0);
+        o["rateLimit"] =
+            MakeOption(&C::rateLimit, "Requests per second per host, 0 = any",
+                       0.0, 1e6);
+        o["rateBurst"] = MakeOption(
+            &C::rateBurst, "Requests allowed at once per host", 1.0, 1e6);
+        o["fileName"] = MakeOption(&C::fileName, "Output file, without .obj");
+        o["profileFile"] =
+            MakeOption(&C::profileFile, "Write stage timings as JSON");
+        o["traceFile"] =
+            MakeOption(&C::traceFile, "Write a Chrome trace of the run");
+        o["meshCacheDir"] = MakeOption(
+            &C::meshCacheDir, "Directory to keep built tile meshes in");
+        o["tileCacheDir"] = MakeOption(
+            &C::tileCacheDir, "Directory to keep fetched tiles in");
+        o["offsetX"] =
+            MakeOption(&C::offsetX, "Output offset along x", -1e9, 1e9);
+        o["offsetY"] =
+            MakeOption(&C::offsetY, "Output offset along y", -1e9, 1e9);
+        o["terrain"] = MakeOption(&C::terrain, "Build the terrain");
+        o["buildings"] = MakeOption(&C::buildings, "Build the buildings");
+        o["roads"] = MakeOption(&C::roads, "Build the roads");
+        o["clipToTile"] = MakeOption(
+            &C::clipToTile, "Cut features at the tile edges, no duplicates");
+        o["pedestal"] = MakeOption(&C::pedestal, "Build a pedestal");
+        o["normals"] = MakeOption(&C::normals, "Export normals");
+        o["simplify"] = MakeOption(&C::simplify, "Simplify the meshes");
+        o["batchMeshes"] =
+            MakeOption(&C::batchMeshes, "One mesh per tile and layer");
+        o["featureIds"] =
+            MakeOption(&C::featureIds, "Keep feature ids per vertex");
+        o["splitMesh"] =
+            MakeOption(&C::splitMesh, "Export each mesh as an object");
+        o["append"] = MakeOption(&C::append, "Append to the output file");
+        o["synthetic"] =
+            MakeOption(&C::synthetic, "Generate the tiles instead of fetching");
+        o["incremental"] = MakeOption(
+            &C::incremental, "Reuse the unchanged tiles of the last output");
+        o["checkpoint"] = MakeOption(
+            &C::checkpoint, "Keep the progress of the run on disk");
+        o["resume"] = MakeOption(
+            &C::resume, "Continue a checkpointed run, failed tiles first");
+        o["skipFailedTiles"] = MakeOption(
+            &C::skipFailedTiles, "Leave out tiles that fail to fetch");
+        o["prefetch"] = MakeOption(
+            &C::prefetch, "Only fetch the tiles into tileCacheDir");
+
+        Option weighting;
+        weighting.type = "uniform|area|angle";
+        weighting.description = "Face weighting of vertex normals";
+        weighting.set = [](ProgramConfig& config, const std::string& value) {
+            config.normalWeighting = ParseNormalWeighting(value);
+        };
+        weighting.get = [](const ProgramConfig& config) {
+            return ToString(config.normalWeighting);
+        };
+        o["normalWeighting"] = weighting;
+
+        o["city.seed"] = MakeCityOption(&G::seed, "Generator seed");
+        o["city.buildingsPerTile"] = MakeCityOption(
+            &G::buildingsPerTile, "Buildings per tile", 0, 10000);
+        o["city.footprintVertices"] = MakeCityOption(
+            &G::footprintVertices, "Vertices per footprint", 3, 64);
+        o["city.roadsPerTile"] =
+            MakeCityOption(&G::roadsPerTile, "Roads per tile", 0, 1000);
+        o["city.roadPoints"] =
+            MakeCityOption(&G::roadPoints, "Points per road", 2, 1024);
+        o["city.heightmapSize"] = MakeCityOption(
+            &G::heightmapSize, "Heightmap samples per side", 2, 1024);
+        o["city.terrainAmplitude"] = MakeCityOption(
+            &G::terrainAmplitude, "Terrain amplitude (m)", 0.0, 1e4);
+        o["city.terrainRoughness"] = MakeCityOption(
+            &G::terrainRoughness, "Terrain roughness [0, 1]", 0.0, 1.0);
+
+        return o;
+    }();
+
+    return options;
+}
+}  // namespace
+
+ProgramConfig ProgramOptions::GetDefaultConfig()
+{
+    ProgramConfig config;
+    config.tileEndpoint = DEFAULT_TILE_ENDPOINT;
+    config.tileX = "19294";
+    config.tileY = "24642";
+    config.tileZ = 16;
+    config.prefetchThreads = 16;
+    config.maxTiles = 65536;
+    config.terrainSubdivision = 64;
+    config.terrainExtrusionScale = 1.0;
+    config.buildingsHeight = 0.0;
+    config.buildingsExtrusionScale = 1.0;
+    config.roadsHeight = 1.0;
+    config.roadsExtrusionWidth = 5.0;
+    config.pedestalHeight = 0.0;
+    config.simplifyRatio = 0.5;
+    config.simplifyMaxError = 1.0;
+    config.downloadCacheSize = 256;
+    config.decodedCacheSize = 256;
+    config.serverCacheSize = 1024;
+    config.retries = 2;
+    config.timeout = 30.0;
+    config.connectTimeout = 10.0;
+    config.downloadRetries = 4;
+    config.retryDelay = 0.5;
+    config.maxRetryDelay = 30.0;
+    config.rateLimit = 0.0;
+    config.rateBurst = 8.0;
+    config.normalWeighting = NormalWeighting::Uniform;
+    config.offsetX = 0.0;
+    config.offsetY = 0.0;
+    config.terrain = false;
+    config.buildings = true;
+    config.roads = false;
+    config.clipToTile = false;
+    config.pedestal = false;
+    config.normals = false;
+    config.simplify = false;
+    config.batchMeshes = false;
+    config.featureIds = false;
+    config.splitMesh = false;
+    config.append = false;
+    config.synthetic = false;
+    config.incremental = false;
+    config.checkpoint = false;
+    config.resume = false;
+    config.skipFailedTiles = false;
+    config.prefetch = false;
+
+    return config;
+}
+
+void ProgramOptions::Set(ProgramConfig& config, const std::string& name,
+                         const std::string& value)
+{
+    const auto& options = GetOptions();
+    const auto it = options.find(name);
+
+    if (it == options.end())
+    {
+        throw std::invalid_argument("Unknown option: " + name);
+    }
+
+    try
+    {
+        it->second.set(config, value);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        throw std::invalid_argument(name + ": " + e.what());
+    }
+}
+
+bool ProgramOptions::Has(const std::string& name)
+{
+    return GetOptions().count(name) > 0;
+}
+
+bool ProgramOptions::IsFlag(const std::string& name)
+{
+    const auto& options = GetOptions();
+    const auto it = options.find(name);
+
+    return it != options.end() && it->second.type == "flag";
+}
+
+void ProgramOptions::Apply(ProgramConfig& config, const nlohmann::json& options)
+{
+    if (!options.is_object())
+    {
+        throw std::invalid_argument("Options must be a JSON object");
+    }
+
+    for (const auto& option : options.items())
+    {
+        const auto& value = option.value();
+        Set(config, option.key(),
+            value.is_string() ? value.get<std::string>() : value.dump());
+    }
+}
+
+nlohmann::json ProgramOptions::ToJSON(const ProgramConfig& config)
+{
+    nlohmann::json options = nlohmann::json::object();
+
+    for (const auto& option : GetOptions())
+    {
+        options[option.first] = option.second.get(config);
+    }
+
+    return options;
+}
+
+std::vector<ProgramConfig> ProgramOptions::LoadJobFile(
+    const std::string& fileName, const ProgramConfig& base)
+{
+    std::ifstream file(fileName);
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open job file: " + fileName);
+    }
+
+    const nlohmann::json jobFile = nlohmann::json::parse(file);
+
+    ProgramConfig defaults = base;
+    if (jobFile.contains("defaults"))
+    {
+        Apply(defaults, jobFile["defaults"]);
+    }
+
+    std::vector<ProgramConfig> jobs;
+
+    for (const auto& job : jobFile.at("jobs"))
+    {
+        jobs.push_back(defaults);
+        Apply(jobs.back(), job);
+    }
+
+    return jobs;
+}
+
+std::string ProgramOptions::GetUsage()
+{
+    std::ostringstream usage;
+
+    for (const auto& option : GetOptions())
+    {
+        std::string name = "--" + option.first;
+        if (option.second.type != "flag")
+        {
+            name += " <" + option.second.type + ">";
+        }
+
+        usage << "  " << name;
+        usage << std::string(name.size() < 36 ? 36 - name.size() : 1, ' ')
+              << option.second.description << "\n";
+    }
+
+    return usage.str();
+}
+}  // namespace CubbyCity
\ No newline at end of file
@@ -0,0 +1,404 @@
+// Copyright (c) 2019 Chris Ohk, Paul Kweon, Den So, Edward Sung
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <CubbyCity/Commons/CommonUtils.hpp>
+#include <CubbyCity/Commons/Constants.hpp>
+#include <CubbyCity/Commons/Macros.hpp>
+#include <CubbyCity/Geometry/Geometry.hpp>
+#include <CubbyCity/Geometry/TileCover.hpp>
+#include <CubbyCity/Programs/ProgramOptions.hpp>
+#include <CubbyCity/Programs/TileServer.hpp>
+
+#if !defined(CUBBYCITY_WINDOWS)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace CubbyCity
+{
+namespace
+{
+// Bounds on the work of one request, the options being open to anyone
+constexpr int MAX_REQUEST_TILES = 64;
+constexpr int MAX_REQUEST_SUBDIVISION = 256;
+
+// A client stalling a transfer would hold every other one up
+constexpr int SOCKET_TIMEOUT_SECONDS = 10;
+
+//! Option a request may set, numeric ones within [min, max].
+struct RequestOption
+{
+    bool numeric;
+    double min;
+    double max;
+};
+
+constexpr RequestOption ANY_VALUE = { false, 0.0, 0.0 };
+
+constexpr RequestOption Range(double min, double max)
+{
+    return { true, min, max };
+}
+
+//! Returns the options a request may set: what to build and how, but not
+//! where tiles come from or files go, nor how hard to retry. Numbers are
+//! kept to ranges that bound the work of a request and the number of
+//! distinct meshes the cache may be asked to hold.
+const std::map<std::string, RequestOption>& GetRequestOptions()
+{
+    static const std::map<std::string, RequestOption> options = {
+        { "tileX", ANY_VALUE },
+        { "tileY", ANY_VALUE },
+        { "tileZ", Range(0, MAX_ZOOM) },
+        { "region", ANY_VALUE },
+        { "maxTiles", Range(1, MAX_REQUEST_TILES) },
+        { "terrain", ANY_VALUE },
+        { "buildings", ANY_VALUE },
+        { "roads", ANY_VALUE },
+        { "clipToTile", ANY_VALUE },
+        { "pedestal", ANY_VALUE },
+        { "normals", ANY_VALUE },
+        { "normalWeighting", ANY_VALUE },
+        { "simplify", ANY_VALUE },
+        { "batchMeshes", ANY_VALUE },
+        { "featureIds", ANY_VALUE },
+        { "splitMesh", ANY_VALUE },
+        { "terrainSubdivision", Range(1, MAX_REQUEST_SUBDIVISION) },
+        { "terrainExtrusionScale", Range(0.0, 10.0) },
+        { "buildingsHeight", Range(0.0, 1000.0) },
+        { "buildingsExtrusionScale", Range(0.0, 10.0) },
+        { "roadsHeight", Range(0.0, 100.0) },
+        { "roadsExtrusionWidth", Range(0.0, 100.0) },
+        { "pedestalHeight", Range(0.0, 1000.0) },
+        { "simplifyRatio", Range(0.0, 1.0) },
+        { "simplifyMaxError", Range(0.0, 1000.0) },
+    };
+
+    return options;
+}
+
+TileServer::Response MakeError(int status, const std::string& message)
+{
+    TileServer::Response response;
+    response.status = status;
+    response.body = std::make_shared<const std::string>(message + "\n");
+
+    return response;
+}
+
+std::string DecodeURL(const std::string& s)
+{
+    std::string result;
+    result.reserve(s.size());
+
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        if (s[i] == '+')
+        {
+            result += ' ';
+        }
+        else if (s[i] == '%' && i + 2 < s.size())
+        {
+            result +=
+                static_cast<char>(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else
+        {
+            result += s[i];
+        }
+    }
+
+    return result;
+}
+
+const char* GetStatusText(int status)
+{
+    switch (status)
+    {
+        case 200:
+            return "OK";
+        case 400:
+            return "Bad Request";
+        case 403:
+            return "Forbidden";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        default:
+            return "Internal Server Error";
+    }
+}
+}  // namespace
+
+TileServer::TileServer(ProgramConfig config,
+                       std::shared_ptr<IDownloader> downloader,
+                       size_t cacheBytes)
+    : m_config(std::move(config)),
+      m_downloader(std::move(downloader)),
+      m_tileCache(std::make_shared<TileCache>(cacheBytes / 2)),
+      m_meshCache(cacheBytes / 2)
+{
+    // Do nothing
+}
+
+TileServer::Response TileServer::Handle(const std::string& target)
+{
+    const auto& options = GetRequestOptions();
+
+    const size_t question = target.find('?');
+    const std::string path = target.substr(0, question);
+    const std::string query =
+        question == std::string::npos ? "" : target.substr(question + 1);
+
+    ProgramConfig config = m_config;
+    std::vector<glm::ivec2> tiles;
+
+    try
+    {
+        for (const auto& parameter : SplitString(query, '&'))
+        {
+            const size_t equal = parameter.find('=');
+            const std::string name = DecodeURL(parameter.substr(0, equal));
+            const std::string value =
+                equal == std::string::npos
+                    ? "true"
+                    : DecodeURL(parameter.substr(equal + 1));
+
+            if (name.empty())
+            {
+                continue;
+            }
+
+            const auto option = options.find(name);
+            if (option == options.end())
+            {
+                return MakeError(403, "Option not allowed: " + name);
+            }
+
+            ProgramOptions::Set(config, name, value);
+
+            // The value parsed, so it is a number when the option is numeric
+            const RequestOption& limit = option->second;
+            if (limit.numeric && !(std::stod(value) >= limit.min &&
+                                   std::stod(value) <= limit.max))
+            {
+                std::ostringstream message;
+                message << name << ": Value out of range [" << limit.min
+                        << ", " << limit.max << "] for a request: " << value;
+                return MakeError(400, message.str());
+            }
+        }
+
+        const std::vector<std::string> parts = SplitString(path, '/');
+
+        // "/tile/z/x/y.obj" splits into "", "tile", z, x, "y.obj"
+        if (parts.size() == 5 && parts[1] == "tile" &&
+            parts[4].size() > 4 &&
+            parts[4].compare(parts[4].size() - 4, 4, ".obj") == 0)
+        {
+            ProgramOptions::Set(config, "tileZ", parts[2]);
+            ProgramOptions::Set(config, "tileX", parts[3]);
+            ProgramOptions::Set(config, "tileY",
+                                parts[4].substr(0, parts[4].size() - 4));
+
+            // A single tile, whatever region the server was started with
+            config.region.clear();
+            config.regionFile.clear();
+        }
+        else if (path != "/region.obj")
+        {
+            return MakeError(404, "Unknown path: " + path);
+        }
+
+        if (config.terrainSubdivision > MAX_REQUEST_SUBDIVISION)
+        {
+            return MakeError(400, "terrainSubdivision is limited to " +
+                                      std::to_string(MAX_REQUEST_SUBDIVISION));
+        }
+
+        config.maxTiles = std::min(config.maxTiles, MAX_REQUEST_TILES);
+        tiles = SelectTiles(config, config.tileZ);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        return MakeError(400, e.what());
+    }
+
+    try
+    {
+        return Build(config, tiles);
+    }
+    catch (const std::exception& e)
+    {
+        return MakeError(500, e.what());
+    }
+}
+
+TileServer::Response TileServer::Build(const ProgramConfig& config,
+                                       const std::vector<glm::ivec2>& tiles)
+{
+    const std::string key = ProgramOptions::ToJSON(config).dump();
+
+    Response response;
+    response.contentType = "model/obj";
+
+    if (m_meshCache.Get(key, response.body))
+    {
+        response.cached = true;
+        return response;
+    }
+
+    Geometry geometry(config, m_downloader, m_tileCache);
+    geometry.ParseTiles(tiles, config.tileZ);
+
+    if (config.synthetic)
+    {
+        geometry.GenerateData(CityGenerator(config.cityGenerator),
+                              config.terrain, config.terrainExtrusionScale,
+                              config.buildings, config.roads);
+    }
+    else
+    {
+        geometry.DownloadData(config.apiKey, config.terrain,
+                              config.terrainExtrusionScale, config.buildings,
+                              config.roads);
+    }
+
+    if (config.terrain)
+    {
+        geometry.AdjustTerrainEdges();
+    }
+
+    geometry.BuildMeshes();
+
+    std::ostringstream stream;
+    geometry.ExportToStream(stream);
+
+    auto body = std::make_shared<const std::string>(stream.str());
+    m_meshCache.Put(key, body, body->size());
+    response.body = std::move(body);
+
+    return response;
+}
+
+void TileServer::Run(unsigned short port)
+{
+#if defined(CUBBYCITY_WINDOWS)
+    (void)port;
+    throw std::runtime_error("Server mode is not supported on Windows");
+#else
+    const int server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server < 0)
+    {
+        throw std::runtime_error("Failed to create the server socket");
+    }
+
+    const int reuse = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    const bool listening =
+        bind(server, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) == 0 &&
+        listen(server, 16) == 0;
+
+    if (!listening)
+    {
+        close(server);
+        throw std::runtime_error("Failed to listen on port " +
+                                 std::to_string(port));
+    }
+
+    // Requests are served one at a time; the downloaders are not reentrant
+    while (true)
+    {
+        const int client = accept(server, nullptr, nullptr);
+        if (client < 0)
+        {
+            continue;
+        }
+
+        timeval timeout{};
+        timeout.tv_sec = SOCKET_TIMEOUT_SECONDS;
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        char buffer[4096];
+
+        while (request.find("\r\n\r\n") == std::string::npos &&
+               request.size() < 65536)
+        {
+            const ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            request.append(buffer, static_cast<size_t>(n));
+        }
+
+        std::istringstream requestLine(request.substr(0, request.find('\r')));
+        std::string method, target;
+        requestLine >> method >> target;
+
+        Response response;
+        if (method == "GET")
+        {
+            response = Handle(target);
+        }
+        else
+        {
+            response = MakeError(405, "Only GET is served");
+            response.headers.emplace_back("Allow", "GET");
+        }
+
+        std::ostringstream header;
+        header << "HTTP/1.1 " << response.status << " "
+               << GetStatusText(response.status) << "\r\n"
+               << "Content-Type: " << response.contentType << "\r\n"
+               << "Content-Length: " << response.body->size() << "\r\n"
+               << "X-Cache: " << (response.cached ? "hit" : "miss") << "\r\n";
+        for (const auto& field : response.headers)
+        {
+            header << field.first << ": " << field.second << "\r\n";
+        }
+        header << "Connection: close\r\n\r\n";
+
+        const std::string head = header.str();
+        send(client, head.data(), head.size(), MSG_NOSIGNAL);
+
+        for (size_t sent = 0; sent < response.body->size();)
+        {
+            const ssize_t n =
+                send(client, response.body->data() + sent,
+                     response.body->size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+            {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+
+        close(client);
+    }
+#endif
+}
+}  // namespace CubbyCity
\ No newline at end of file